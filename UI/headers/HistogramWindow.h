@@ -2,6 +2,7 @@
 #define HISTOGRAMWINDOW_H
 
 #include <QComboBox>
+#include <QDoubleSpinBox>
 #include <QHBoxLayout>
 #include <QLineEdit>
 #include <QListWidget>
@@ -27,7 +28,6 @@ public:
     void generateTable();
     void plotHistograms();
     QMap<QString, int> calculateHistogramData(const ArraySequence<int>& data, const QString& param);
-    std::pair<int, int> getRange(int field, const ArraySequence<std::pair<int, int>>& ranges);
 
 private:
     void applyStyles();
@@ -36,6 +36,7 @@ private:
 
     QLineEdit *filePathEdit;
     QComboBox *splitParameterComboBox;
+    QDoubleSpinBox *quantileErrorSpinBox;
     QLineEdit *rangeStartEdit;
     QLineEdit *rangeEndEdit;
     QTableWidget *resultTable;
@@ -47,6 +48,7 @@ private:
     ArraySequence<std::pair<int, int>> rangesArray;
     QPushButton *plotButton;
     IDictionary<std::pair<int, int>, PartitionStatistics> cachedStats;
+    bool cachedSketched = false;
     QScrollArea *scrollArea;
     QWidget *chartsContainer;
 };
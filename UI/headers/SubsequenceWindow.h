@@ -4,6 +4,8 @@
 #include <QWidget>
 #include <QLineEdit>
 #include <QSpinBox>
+#include <QComboBox>
+#include <QDoubleSpinBox>
 #include <QPushButton>
 #include <QLabel>
 
@@ -23,6 +25,13 @@ private:
     QLineEdit *filePathField;
     QSpinBox *lminSpinBox;
     QSpinBox *lmaxSpinBox;
+    QSpinBox *topKSpinBox;
+    QSpinBox *threadCountSpinBox;
+    QSpinBox *memoryBudgetSpinBox;
+    QComboBox *orderComboBox;
+    QComboBox *formatComboBox;
+    QComboBox *unitComboBox;
+    QDoubleSpinBox *approximateErrorSpinBox;
     QLineEdit *saveLocationField;
     QPushButton *loadFileButton;
     QPushButton *chooseSaveButton;
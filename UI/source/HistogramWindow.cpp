@@ -9,6 +9,7 @@
 
 HistogramWindow::HistogramWindow(QWidget* parent) :
     QWidget(parent), filePathEdit(new QLineEdit(this)), splitParameterComboBox(new QComboBox(this)),
+    quantileErrorSpinBox(new QDoubleSpinBox(this)),
     rangeStartEdit(new QLineEdit(this)), rangeEndEdit(new QLineEdit(this)), resultTable(new QTableWidget(this)),
     rangeList(new QListWidget(this)), addRangeButton(new QPushButton("Добавить разбиение", this)),
     selectFileButton(new QPushButton("Выбрать файл", this)),
@@ -30,6 +31,16 @@ HistogramWindow::HistogramWindow(QWidget* parent) :
     rangeLayout->addWidget(rangeEndEdit);
     rangeLayout->addWidget(addRangeButton);
 
+    quantileErrorSpinBox->setRange(0, 0.1);
+    quantileErrorSpinBox->setDecimals(4);
+    quantileErrorSpinBox->setSingleStep(0.001);
+    quantileErrorSpinBox->setValue(0);
+    quantileErrorSpinBox->setButtonSymbols(QAbstractSpinBox::NoButtons);
+
+    auto* quantileLayout = new QHBoxLayout();
+    quantileLayout->addWidget(new QLabel("Погрешность квантилей (0 - точно, без графиков при приближении):", this));
+    quantileLayout->addWidget(quantileErrorSpinBox);
+
     rangeList->setMaximumHeight(100);
     auto* rangeListLayout = new QVBoxLayout();
     rangeListLayout->addWidget(rangeList);
@@ -39,6 +50,7 @@ HistogramWindow::HistogramWindow(QWidget* parent) :
     mainLayout->addLayout(fileLayout);
     mainLayout->addLayout(rangeLayout);
     mainLayout->addLayout(rangeListLayout);
+    mainLayout->addLayout(quantileLayout);
     mainLayout->addWidget(resultTable);
     mainLayout->addWidget(generateTableButton);
     mainLayout->addWidget(plotButton);
@@ -59,7 +71,7 @@ void HistogramWindow::applyStyles() {
         QWidget {
             background-color: #f9f9f9;
         }
-        QLineEdit, QComboBox, QPushButton, QListWidget, QTableWidget {
+        QLineEdit, QComboBox, QDoubleSpinBox, QPushButton, QListWidget, QTableWidget {
             background-color: #ffffff;
             color: #000000; /* Черный текст */
             border: 1px solid #cccccc;
@@ -68,7 +80,7 @@ void HistogramWindow::applyStyles() {
             background-color: #ffffff;
             color: #000000; /* Черный текст в выпадающем списке */
         }
-        QLineEdit, QComboBox {
+        QLineEdit, QComboBox, QDoubleSpinBox {
             padding: 5px;
         }
         QPushButton {
@@ -147,9 +159,18 @@ void HistogramWindow::addRange() {
         return;
     }
 
+    ArraySequence<std::pair<int, int>> candidate = rangesArray;
+    candidate.Append({start, end});
+    try {
+        RangeIndex validated(candidate);
+    } catch (const std::invalid_argument&) {
+        QMessageBox::warning(this, "Ошибка", "Разбиение пересекается с уже добавленным.");
+        return;
+    }
+
     QString rangeText = QString("От %1 до %2").arg(start).arg(end);
     rangeList->addItem(rangeText);
-    rangesArray.Append({start, end});
+    rangesArray = std::move(candidate);
 }
 
 void HistogramWindow::openFileDialog() {
@@ -169,6 +190,11 @@ void HistogramWindow::generateTable() {
         return;
     }
 
+    if (RangeIndex(rangesArray).HasGaps()) {
+        QMessageBox::warning(this, "Предупреждение",
+                             "Между разбиениями есть промежутки: люди со значениями в них не войдут в таблицу.");
+    }
+
     ArraySequence<Person> persons;
     std::ios::sync_with_stdio(false);
     std::cin.tie(nullptr);
@@ -217,7 +243,8 @@ void HistogramWindow::generateTable() {
 
     file.close();
 
-    Histogram histogram;
+    Histogram histogram(quantileErrorSpinBox->value());
+    cachedSketched = histogram.IsSketched();
 
     if (parameter == "Возраст") {
         histogram.Build(persons, rangesArray, [](const Person& p) { return p.getAge(); });
@@ -268,6 +295,10 @@ void HistogramWindow::plotHistograms() {
         QMessageBox::warning(this, "Ошибка", "Сначала получите данные.");
         return;
     }
+    if (cachedSketched) {
+        QMessageBox::warning(this, "Ошибка", "Графики строятся только по точным данным: задайте погрешность 0.");
+        return;
+    }
 
     auto *window = new QWidget();
     window->setWindowTitle("Графики разбиений");
@@ -452,13 +483,3 @@ QMap<QString, int> HistogramWindow::calculateHistogramData(const ArraySequence<i
 
     return bins;
 }
-
-
-std::pair<int, int> HistogramWindow::getRange(const int field, const ArraySequence<std::pair<int, int>>& ranges) {
-    for (const auto& range : ranges) {
-        if (field >= range.first && field < range.second) {
-            return range;
-        }
-    }
-    return {-1, -1};
-}
\ No newline at end of file
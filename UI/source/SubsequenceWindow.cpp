@@ -1,13 +1,19 @@
 #include "..//headers/SubsequenceWindow.h"
 #include "../../headers/MostFrequentSubsequences.h"
+#include "../../headers/WordNGrams.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QThread>
 
 SubsequenceWindow::SubsequenceWindow(QWidget *parent)
     : QWidget(parent), filePathField(new QLineEdit(this)),
       lminSpinBox(new QSpinBox(this)), lmaxSpinBox(new QSpinBox(this)),
+      topKSpinBox(new QSpinBox(this)), threadCountSpinBox(new QSpinBox(this)),
+      memoryBudgetSpinBox(new QSpinBox(this)), orderComboBox(new QComboBox(this)),
+      formatComboBox(new QComboBox(this)), unitComboBox(new QComboBox(this)),
+      approximateErrorSpinBox(new QDoubleSpinBox(this)),
       saveLocationField(new QLineEdit(this)), loadFileButton(new QPushButton("Загрузить файл", this)),
       chooseSaveButton(new QPushButton("Выбрать папку сохранения", this)),
       processButton(new QPushButton("Получить данные", this)),
@@ -19,15 +25,37 @@ SubsequenceWindow::SubsequenceWindow(QWidget *parent)
     lmaxSpinBox->setRange(1, 1000);
     lminSpinBox->setValue(1);
     lmaxSpinBox->setValue(10);
+    topKSpinBox->setRange(0, 1000000);
+    topKSpinBox->setValue(0);
+    threadCountSpinBox->setRange(1, 256);
+    threadCountSpinBox->setValue(QThread::idealThreadCount());
+    memoryBudgetSpinBox->setRange(0, 1048576);
+    memoryBudgetSpinBox->setValue(0);
+    approximateErrorSpinBox->setRange(0, 0.1);
+    approximateErrorSpinBox->setDecimals(7);
+    approximateErrorSpinBox->setSingleStep(0.0001);
+    approximateErrorSpinBox->setValue(0);
+    orderComboBox->addItem("Без сортировки", static_cast<int>(OutputOrder::Table));
+    orderComboBox->addItem("По убыванию частоты", static_cast<int>(OutputOrder::CountDescending));
+    orderComboBox->addItem("По алфавиту", static_cast<int>(OutputOrder::KeyAscending));
+    formatComboBox->addItem("Текст (result.txt)", static_cast<int>(OutputFormat::Text));
+    formatComboBox->addItem("Двоичный (result.bin)", static_cast<int>(OutputFormat::Binary));
+    unitComboBox->addItem("Символы (UTF-8)", static_cast<int>(TextUnit::CodePoint));
+    unitComboBox->addItem("Байты", static_cast<int>(TextUnit::Byte));
+    unitComboBox->addItem("Слова", static_cast<int>(TextUnit::Word));
 
     lminSpinBox->setButtonSymbols(QAbstractSpinBox::NoButtons);
     lmaxSpinBox->setButtonSymbols(QAbstractSpinBox::NoButtons);
+    topKSpinBox->setButtonSymbols(QAbstractSpinBox::NoButtons);
+    threadCountSpinBox->setButtonSymbols(QAbstractSpinBox::NoButtons);
+    memoryBudgetSpinBox->setButtonSymbols(QAbstractSpinBox::NoButtons);
+    approximateErrorSpinBox->setButtonSymbols(QAbstractSpinBox::NoButtons);
 
     setStyleSheet(R"(
         QWidget {
             background-color: #f9f9f9;
         }
-        QLineEdit, QSpinBox {
+        QLineEdit, QSpinBox, QDoubleSpinBox, QComboBox {
             background-color: #ffffff;
             color: #333333;
             border: 1px solid #cccccc;
@@ -66,6 +94,26 @@ SubsequenceWindow::SubsequenceWindow(QWidget *parent)
     rangeLayout->addWidget(lminSpinBox);
     rangeLayout->addWidget(new QLabel("Максимальная длина подстроки:", this));
     rangeLayout->addWidget(lmaxSpinBox);
+    rangeLayout->addWidget(new QLabel("Длина в:", this));
+    rangeLayout->addWidget(unitComboBox);
+
+    auto *topKLayout = new QHBoxLayout();
+    topKLayout->addWidget(new QLabel("Количество самых частых подстрок каждой длины (0 - все):", this));
+    topKLayout->addWidget(topKSpinBox);
+    topKLayout->addWidget(new QLabel("Количество потоков:", this));
+    topKLayout->addWidget(threadCountSpinBox);
+
+    auto *memoryLayout = new QHBoxLayout();
+    memoryLayout->addWidget(new QLabel("Ограничение памяти, МБ (0 - без ограничения):", this));
+    memoryLayout->addWidget(memoryBudgetSpinBox);
+    memoryLayout->addWidget(new QLabel("Погрешность приближённого подсчёта (0 - точно):", this));
+    memoryLayout->addWidget(approximateErrorSpinBox);
+
+    auto *outputLayout = new QHBoxLayout();
+    outputLayout->addWidget(new QLabel("Порядок вывода:", this));
+    outputLayout->addWidget(orderComboBox);
+    outputLayout->addWidget(new QLabel("Формат вывода:", this));
+    outputLayout->addWidget(formatComboBox);
 
     auto *saveLayout = new QHBoxLayout();
     saveLayout->addWidget(chooseSaveButton);
@@ -73,6 +121,9 @@ SubsequenceWindow::SubsequenceWindow(QWidget *parent)
 
     mainLayout->addLayout(fileInputLayout);
     mainLayout->addLayout(rangeLayout);
+    mainLayout->addLayout(topKLayout);
+    mainLayout->addLayout(memoryLayout);
+    mainLayout->addLayout(outputLayout);
     mainLayout->addLayout(saveLayout);
     mainLayout->addWidget(processButton);
     mainLayout->addWidget(statusLabel);
@@ -103,6 +154,11 @@ void SubsequenceWindow::processSubsequences() {
     QString filePath = filePathField->text();
     int lmin = lminSpinBox->value();
     int lmax = lmaxSpinBox->value();
+    int topK = topKSpinBox->value();
+    int threadCount = threadCountSpinBox->value();
+    int memoryBudget = memoryBudgetSpinBox->value();
+    auto unit = static_cast<TextUnit>(unitComboBox->currentData().toInt());
+    double approximateError = approximateErrorSpinBox->value();
     QString saveLocation = saveLocationField->text();
 
     if (filePath.isEmpty()) {
@@ -115,6 +171,33 @@ void SubsequenceWindow::processSubsequences() {
         return;
     }
 
-    processFileAndSaveResults(filePath.toStdString(), saveLocation.toStdString(), lmin, lmax);
+    if (unit == TextUnit::Word && static_cast<size_t>(lmax) > TokenNGram::maxLength) {
+        statusLabel->setText(QString("Ошибка: Максимальная длина в словах - %1.").arg(TokenNGram::maxLength));
+        return;
+    }
+
+    if (approximateError > 0 && (topK == 0 || unit != TextUnit::Byte)) {
+        statusLabel->setText("Ошибка: Приближённый подсчёт требует количества подстрок и длины в байтах.");
+        return;
+    }
+
+    if (memoryBudget > 0 && topK == 0 && unit != TextUnit::Byte) {
+        statusLabel->setText("Ошибка: При ограничении памяти длина считается только в байтах.");
+        return;
+    }
+
+    SubsequenceSearchOptions options;
+    options.threadCount = threadCount;
+    options.memoryBudget = static_cast<size_t>(memoryBudget) << 20;
+    options.order = static_cast<OutputOrder>(orderComboBox->currentData().toInt());
+    options.format = static_cast<OutputFormat>(formatComboBox->currentData().toInt());
+    options.unit = unit;
+    options.approximateError = approximateError;
+    if (topK > 0) {
+        options.engine = CountingEngine::SuffixArray;
+        options.topK = topK;
+    }
+
+    processFileAndSaveResults(filePath.toStdString(), saveLocation.toStdString(), lmin, lmax, options);
     QMessageBox::information(this, "Готово", "Данные успешно обработаны и сохранены!");
 }
@@ -0,0 +1,119 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../headers/ApproximateSubstringCounter.h"
+#include "../headers/MostFrequentSubsequences.h"
+#include "../headers/TopK.h"
+
+namespace {
+    size_t residentMegabytes() {
+        std::ifstream statm("/proc/self/statm");
+        size_t total = 0;
+        size_t resident = 0;
+        statm >> total >> resident;
+        return resident * 4096 / (1024 * 1024);
+    }
+
+    double millisecondsSince(const std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Words drawn from a Zipf(1) vocabulary, so a few substrings dominate like in natural text.
+    std::string zipfText(const size_t length, const size_t vocabularySize) {
+        std::mt19937 generator(42);
+        ArraySequence<std::string> vocabulary(vocabularySize);
+        for (auto& word: vocabulary) {
+            const size_t wordLength = 2 + generator() % 8;
+            for (size_t i = 0; i < wordLength; ++i) {
+                word.push_back(static_cast<char>('a' + generator() % 26));
+            }
+        }
+
+        std::vector<double> weights(vocabularySize);
+        for (size_t rank = 0; rank < vocabularySize; ++rank) {
+            weights[rank] = 1.0 / static_cast<double>(rank + 1);
+        }
+        std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+
+        std::string text;
+        text.reserve(length + 16);
+        while (text.size() < length) {
+            text += vocabulary[pick(generator)];
+            text.push_back(' ');
+        }
+        return text;
+    }
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t length = argc > 1 ? std::stoul(argv[1]) : 4000000;
+    const size_t lmin = argc > 2 ? std::stoul(argv[2]) : 4;
+    const size_t lmax = argc > 3 ? std::stoul(argv[3]) : 8;
+    const size_t k = argc > 4 ? std::stoul(argv[4]) : 20;
+    const double delta = 0.01;
+
+    const std::string text = zipfText(length, 50000);
+
+    // The exact path: every distinct substring in an IDictionary, then top-K per length.
+    size_t residentBefore = residentMegabytes();
+    auto start = std::chrono::steady_clock::now();
+    StringArena arena;
+    IDictionary<std::string_view, size_t, FNV1a<std::string_view>> exact =
+            createPrefixTableArena(text, lmin, lmax, arena);
+    ArraySequence<TopK<std::string_view>> exactTop;
+    for (size_t len = lmin; len <= lmax; ++len) {
+        exactTop.Append(TopK<std::string_view>(k));
+    }
+    for (const auto& [key, value]: exact) {
+        exactTop[key.size() - lmin].Push(key, value);
+    }
+    const double exactMs = millisecondsSince(start);
+    const size_t exactResident = residentMegabytes() - residentBefore;
+
+    IDictionary<std::string_view, size_t, FNV1a<std::string_view>> exactKeys;
+    for (const auto& top: exactTop) {
+        for (const auto& [key, value]: top.GetSorted()) {
+            exactKeys.Insert(key, value);
+        }
+    }
+
+    std::cout << "mode,epsilon,build_ms,memory_mb,recall,max_over,mean_over,bound\n";
+    std::cout << "exact,0," << exactMs << ',' << exactResident << ",1,0,0,0\n";
+
+    for (const double epsilon: {1e-3, 1e-4, 1e-5, 1e-6}) {
+        residentBefore = residentMegabytes();
+        start = std::chrono::steady_clock::now();
+        ApproximateSubstringCounter counter(lmin, lmax, k, epsilon, delta);
+        for (size_t offset = 0; offset < text.size(); offset += size_t{1} << 20) {
+            counter.Feed(std::string_view(text).substr(offset, size_t{1} << 20));
+        }
+        const auto approximate = counter.Finish();
+        const double approximateMs = millisecondsSince(start);
+        const size_t approximateResident = residentMegabytes() - residentBefore;
+
+        size_t found = 0;
+        size_t reported = 0;
+        size_t maxOver = 0;
+        double totalOver = 0;
+        for (const auto& top: approximate) {
+            for (const auto& [key, value]: top) {
+                found += exactKeys.Contains(key);
+                const size_t over = value - exact.Get(key);
+                maxOver = std::max(maxOver, over);
+                totalOver += static_cast<double>(over);
+                ++reported;
+            }
+        }
+
+        std::cout << "count-min," << epsilon << ',' << approximateMs << ',' << approximateResident << ','
+                  << static_cast<double>(found) / static_cast<double>(exactKeys.GetCount()) << ',' << maxOver << ','
+                  << totalOver / static_cast<double>(std::max<size_t>(reported, 1)) << ','
+                  << counter.GetErrorBound() << '\n';
+    }
+
+    return 0;
+}
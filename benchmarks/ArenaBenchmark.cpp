@@ -0,0 +1,87 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <optional>
+#include <random>
+#include <string>
+
+#include "../headers/MostFrequentSubsequences.h"
+
+namespace {
+    std::atomic<size_t> allocationCount{0};
+
+    size_t residentMegabytes() {
+        std::ifstream statm("/proc/self/statm");
+        size_t total = 0;
+        size_t resident = 0;
+        statm >> total >> resident;
+        return resident * 4096 / (1024 * 1024);
+    }
+
+    double millisecondsSince(const std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Stands in for the arena where the table owns its keys.
+    struct OwnedKeys {};
+
+    // KeyStorage is created and destroyed inside the timed scopes, so build and destroy times cover the key
+    // bytes wherever they live.
+    template<typename KeyStorage, typename Build>
+    void measure(const std::string& name, Build&& build) {
+        const size_t allocationsBefore = allocationCount.load();
+        const size_t residentBefore = residentMegabytes();
+        const auto buildStart = std::chrono::steady_clock::now();
+
+        std::optional<KeyStorage> keys;
+        keys.emplace();
+        auto table = build(*keys);
+
+        const double buildMs = millisecondsSince(buildStart);
+        const size_t allocations = allocationCount.load() - allocationsBefore;
+        const size_t resident = residentMegabytes() - residentBefore;
+        const size_t distinct = table.GetCount();
+
+        const auto destroyStart = std::chrono::steady_clock::now();
+        table = decltype(table)();
+        keys.reset();
+        const double destroyMs = millisecondsSince(destroyStart);
+
+        std::cout << name << ',' << distinct << ',' << allocations << ',' << resident << ',' << buildMs << ','
+                  << destroyMs << '\n';
+    }
+} // namespace
+
+void* operator new(const size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, size_t) noexcept { std::free(pointer); }
+
+int main(int argc, char* argv[]) {
+    const size_t length = argc > 1 ? std::stoul(argv[1]) : 200000;
+    const size_t lmin = argc > 2 ? std::stoul(argv[2]) : 16;
+    const size_t lmax = argc > 3 ? std::stoul(argv[3]) : 24;
+
+    std::mt19937 generator(42);
+    std::string text(length, ' ');
+    for (char& symbol: text) {
+        symbol = static_cast<char>('a' + generator() % 26);
+    }
+
+    std::cout << "keys,distinct,allocations,rss_delta_mb,build_ms,destroy_ms\n";
+    measure<OwnedKeys>("std::string", [&](OwnedKeys&) { return createPrefixTable(text, lmin, lmax); });
+    measure<StringArena>("arena",
+                         [&](StringArena& arena) { return createPrefixTableArena(text, lmin, lmax, arena); });
+
+    return 0;
+}
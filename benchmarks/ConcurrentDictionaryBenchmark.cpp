@@ -0,0 +1,67 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "../headers/ConcurrentDictionary.h"
+#include "../headers/FNV1aHash.h"
+#include "../headers/Parallel.h"
+
+namespace {
+    struct RunResult {
+        double seconds;
+        bool consistent;
+    };
+
+    // Every thread increments every key of the shared key set, so each final count must equal the thread count
+    // times the number of rounds; any lost update under contention or during a stripe resize shows up here.
+    RunResult run(const size_t threads, const ArraySequence<std::string>& keys, const size_t rounds) {
+        ConcurrentDictionary<std::string, size_t, FNV1a<std::string>> dictionary;
+
+        const auto start = std::chrono::steady_clock::now();
+        parallelFor(threads, [&](const size_t worker) {
+            const size_t count = keys.GetLength();
+            for (size_t round = 0; round < rounds; ++round) {
+                for (size_t i = 0; i < count; ++i) {
+                    dictionary.Add(keys[(i + worker * 7919) % count], 1);
+                }
+            }
+        });
+        const auto finish = std::chrono::steady_clock::now();
+
+        bool consistent = dictionary.GetCount() == keys.GetLength();
+        dictionary.ForEach([&](const std::string&, const size_t value) {
+            consistent = consistent && value == threads * rounds;
+        });
+
+        return {std::chrono::duration<double>(finish - start).count(), consistent};
+    }
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t keyCount = argc > 1 ? std::stoul(argv[1]) : 200000;
+    const size_t rounds = argc > 2 ? std::stoul(argv[2]) : 4;
+    const size_t maxThreads = resolveThreadCount(argc > 3 ? std::stoul(argv[3]) : 0);
+
+    ArraySequence<std::string> keys;
+    for (size_t i = 0; i < keyCount; ++i) {
+        keys.Append("key-" + std::to_string(i));
+    }
+
+    std::cout << "threads,operations,seconds,mops_per_second,speedup,consistent\n";
+    double baseline = 0.0;
+    bool allConsistent = true;
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        const RunResult result = run(threads, keys, rounds);
+        const double operations = static_cast<double>(threads * rounds * keyCount);
+        const double throughput = operations / result.seconds / 1e6;
+        if (threads == 1) {
+            baseline = throughput;
+        }
+        allConsistent = allConsistent && result.consistent;
+        std::cout << threads << ',' << threads * rounds * keyCount << ',' << result.seconds << ',' << throughput
+                  << ',' << throughput / baseline << ',' << (result.consistent ? "yes" : "no") << '\n';
+    }
+
+    return allConsistent ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "../headers/FNV1aHash.h"
+#include "../headers/IDictionary.h"
+
+namespace {
+    template<typename Function>
+    double measureNanoseconds(const size_t operations, Function&& function) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        const auto finish = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(finish - start).count() / static_cast<double>(operations);
+    }
+
+    template<typename TKey, typename Hasher>
+    void benchmarkDictionary(const std::string& name, const ArraySequence<TKey>& keys,
+                             const ArraySequence<TKey>& missingKeys) {
+        const size_t count = keys.GetLength();
+        IDictionary<TKey, size_t, Hasher> dictionary;
+        size_t checksum = 0;
+
+        const double insertNs = measureNanoseconds(count, [&] {
+            for (const auto& key: keys) {
+                ++dictionary.FindOrInsert(key, 0);
+            }
+        });
+
+        const double hitNs = measureNanoseconds(count, [&] {
+            for (const auto& key: keys) {
+                checksum += dictionary.Get(key);
+            }
+        });
+
+        const double missNs = measureNanoseconds(missingKeys.GetLength(), [&] {
+            for (const auto& key: missingKeys) {
+                checksum += dictionary.Contains(key);
+            }
+        });
+
+        std::cout << name << ',' << count << ',' << dictionary.GetCount() << ',' << dictionary.GetCapacity() << ','
+                  << dictionary.GetAverageProbeLength() << ',' << insertNs << ',' << hitNs << ',' << missNs << ','
+                  << checksum << '\n';
+    }
+
+    // Longest single insertion: with a one-shot rehash this is the stall of the last doubling, incremental
+    // rehashing leaves only the allocation of the doubled arrays, and a reserved table never grows.
+    template<typename TKey, typename Hasher>
+    void benchmarkInsertLatency(const std::string& name, const ArraySequence<TKey>& keys, const bool incremental,
+                                const bool reserve) {
+        IDictionary<TKey, size_t, Hasher> dictionary(16, 0.9, incremental);
+        if (reserve) {
+            dictionary.Reserve(keys.GetLength());
+        }
+        double worst = 0.0;
+        double total = 0.0;
+
+        for (const auto& key: keys) {
+            const auto start = std::chrono::steady_clock::now();
+            ++dictionary.FindOrInsert(key, 0);
+            const double elapsed =
+                    std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+            worst = std::max(worst, elapsed);
+            total += elapsed;
+        }
+
+        std::cout << name << ',' << (reserve ? "reserved" : incremental ? "incremental" : "one-shot") << ','
+                  << keys.GetLength() << ',' << total / 1000.0 << ',' << worst << '\n';
+    }
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+    ArraySequence<size_t> integers;
+    ArraySequence<size_t> missingIntegers;
+    ArraySequence<std::string> strings;
+    ArraySequence<std::string> missingStrings;
+    for (size_t i = 0; i < count; ++i) {
+        integers.Append(i * 7919);
+        missingIntegers.Append(i * 7919 + 1);
+        strings.Append("substring-key-" + std::to_string(i));
+        missingStrings.Append("missing-key-" + std::to_string(i));
+    }
+
+    std::cout << "dictionary,keys,distinct,capacity,avg_probe_length,insert_ns,hit_ns,miss_ns,checksum\n";
+    benchmarkDictionary<size_t, FNV1a<size_t>>("size_t/FNV1a", integers, missingIntegers);
+    benchmarkDictionary<std::string, FNV1a<std::string>>("string/FNV1a", strings, missingStrings);
+
+    std::cout << "\ndictionary,rehash,keys,total_ms,max_insert_us\n";
+    benchmarkInsertLatency<std::string, FNV1a<std::string>>("string/FNV1a", strings, false, false);
+    benchmarkInsertLatency<std::string, FNV1a<std::string>>("string/FNV1a", strings, true, false);
+    benchmarkInsertLatency<std::string, FNV1a<std::string>>("string/FNV1a", strings, false, true);
+
+    return 0;
+}
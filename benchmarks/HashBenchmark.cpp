@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "../../sequences/arraySequence.h"
+#include "../../sorting/quickSort.h"
+#include "../headers/Crc32Hash.h"
+#include "../headers/FNV1aHash.h"
+#include "../headers/IDictionary.h"
+#include "../headers/MurmurHash.h"
+#include "../headers/PairHash.h"
+
+// Hash quality and throughput report. Every section is a CSV block with its own header line, so a run can be
+// split on blank lines and diffed against a previous one.
+namespace {
+    constexpr size_t avalancheSamples = 4000;
+
+    template<typename TKey>
+    size_t keyBytes(const TKey& key) {
+        if constexpr (String<TKey>) {
+            return std::string_view(key).size();
+        } else {
+            return sizeof(TKey);
+        }
+    }
+
+    template<typename TKey, typename Hasher>
+    void benchmarkThroughput(const std::string& name, const std::string& keySet, const ArraySequence<TKey>& keys) {
+        constexpr size_t rounds = 5;
+        const Hasher hasher;
+        size_t bytes = 0;
+        for (const auto& key: keys) {
+            bytes += keyBytes(key);
+        }
+
+        size_t checksum = 0;
+        double best = 0.0;
+        for (size_t round = 0; round < rounds; ++round) {
+            const auto start = std::chrono::steady_clock::now();
+            for (const auto& key: keys) {
+                checksum += hasher(key);
+            }
+            const double elapsed =
+                    std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            best = round == 0 ? elapsed : std::min(best, elapsed);
+        }
+
+        const size_t n = keys.GetLength();
+        std::cout << name << ',' << keySet << ',' << n << ',' << static_cast<double>(bytes) / n << ',' << best / n
+                  << ',' << static_cast<double>(bytes) * 1000.0 / best << ','
+                  << (checksum & 0xFF) << '\n';
+    }
+
+    template<typename TKey, typename Hasher, typename Project>
+    size_t countCollisions(const ArraySequence<TKey>& keys, Project&& project) {
+        const Hasher hasher;
+        const size_t n = keys.GetLength();
+        ArraySequence<size_t> projected(n);
+        for (size_t i = 0; i < n; ++i) {
+            projected[i] = project(hasher(keys[i]));
+        }
+        QuickSorter<size_t> sorter;
+        sorter.Sort(projected, [](const size_t& left, const size_t& right) { return left < right; });
+
+        size_t collisions = 0;
+        for (size_t i = 1; i < n; ++i) {
+            collisions += projected[i] == projected[i - 1];
+        }
+        return collisions;
+    }
+
+    double expectedCollisions(const size_t keys, const size_t buckets) {
+        const double m = static_cast<double>(buckets);
+        return keys - m * (1.0 - std::pow(1.0 - 1.0 / m, static_cast<double>(keys)));
+    }
+
+    // Collisions of n distinct keys in m = bit_ceil(n) buckets, once on the low bits (IDictionary slot index)
+    // and once on the high bits (fingerprint and ConcurrentDictionary stripe). A uniform hash gives a ratio to
+    // the balls-into-bins expectation of about 1.
+    template<typename TKey, typename Hasher>
+    void benchmarkCollisions(const std::string& name, const std::string& keySet, const ArraySequence<TKey>& keys) {
+        const size_t n = keys.GetLength();
+        const size_t buckets = std::bit_ceil(n);
+        const int shift = 64 - std::countr_zero(buckets);
+
+        const size_t full = countCollisions<TKey, Hasher>(keys, [](const size_t hash) { return hash; });
+        const size_t low =
+                countCollisions<TKey, Hasher>(keys, [&](const size_t hash) { return hash & (buckets - 1); });
+        const size_t high =
+                countCollisions<TKey, Hasher>(keys, [&](const size_t hash) { return shift == 64 ? 0 : hash >> shift; });
+        const double expected = expectedCollisions(n, buckets);
+
+        std::cout << name << ',' << keySet << ',' << n << ',' << buckets << ',' << full << ',' << low << ','
+                  << low / expected << ',' << high << ',' << high / expected << '\n';
+    }
+
+    // Flips every input bit of random keys and records how often each output bit changes. Ideal is 0.5 for
+    // every (input, output) pair; max_bias is the worst deviation from it.
+    template<typename Hasher, size_t Bytes, typename MakeKey>
+    void benchmarkAvalanche(const std::string& name, MakeKey&& makeKey) {
+        const Hasher hasher;
+        std::mt19937_64 generator(2024);
+        ArraySequence<size_t> flips(Bytes * 8 * 64);
+        unsigned char input[Bytes];
+
+        for (size_t sample = 0; sample < avalancheSamples; ++sample) {
+            for (unsigned char& byte: input) {
+                byte = static_cast<unsigned char>(generator());
+            }
+            const size_t base = hasher(makeKey(input));
+            for (size_t bit = 0; bit < Bytes * 8; ++bit) {
+                input[bit / 8] ^= static_cast<unsigned char>(1U << bit % 8);
+                const size_t changed = base ^ hasher(makeKey(input));
+                input[bit / 8] ^= static_cast<unsigned char>(1U << bit % 8);
+                for (size_t out = 0; out < 64; ++out) {
+                    flips[bit * 64 + out] += changed >> out & 1;
+                }
+            }
+        }
+
+        double total = 0.0;
+        double maxBias = 0.0;
+        for (const size_t count: flips) {
+            const double probability = static_cast<double>(count) / avalancheSamples;
+            total += probability;
+            maxBias = std::max(maxBias, std::abs(probability - 0.5));
+        }
+
+        std::cout << name << ',' << Bytes * 8 << ',' << total / flips.GetLength() << ',' << maxBias << '\n';
+    }
+
+    // Clustering hashers turn every insertion into a long scan, so filling stops after a time budget and the
+    // row reports how many keys made it in.
+    template<typename TKey, typename Hasher>
+    void benchmarkProbeLength(const std::string& name, const std::string& keySet, const ArraySequence<TKey>& keys) {
+        constexpr double budgetSeconds = 10.0;
+        IDictionary<TKey, size_t, Hasher> dictionary;
+        const auto start = std::chrono::steady_clock::now();
+        bool complete = true;
+
+        for (size_t i = 0; i < keys.GetLength(); ++i) {
+            if (i % 4096 == 0 &&
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > budgetSeconds) {
+                complete = false;
+                break;
+            }
+            ++dictionary.FindOrInsert(keys[i], 0);
+        }
+
+        std::cout << name << ',' << keySet << ',' << dictionary.GetCount() << ',' << dictionary.GetCapacity() << ','
+                  << dictionary.GetAverageProbeLength() << ',' << (complete ? "complete" : "truncated") << '\n';
+    }
+
+    template<typename TKey, typename Hasher>
+    void benchmarkKeySet(const std::string& name, const std::string& keySet, const ArraySequence<TKey>& keys,
+                         const int section) {
+        switch (section) {
+            case 0:
+                benchmarkThroughput<TKey, Hasher>(name, keySet, keys);
+                break;
+            case 1:
+                benchmarkCollisions<TKey, Hasher>(name, keySet, keys);
+                break;
+            default:
+                benchmarkProbeLength<TKey, Hasher>(name, keySet, keys);
+                break;
+        }
+    }
+
+    template<typename T>
+    T loadValue(const unsigned char* bytes) {
+        T value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+    ArraySequence<size_t> sequential(count);
+    ArraySequence<size_t> strided(count);
+    ArraySequence<double> doubles(count);
+    ArraySequence<int> pointees(count);
+    ArraySequence<const int*> pointers(count);
+    ArraySequence<std::pair<int, int>> pairs(count);
+    ArraySequence<std::string> labels(count);
+    for (size_t i = 0; i < count; ++i) {
+        sequential[i] = i;
+        strided[i] = i << 12;
+        doubles[i] = static_cast<double>(i) * 0.5;
+        pointers[i] = &pointees[i];
+        pairs[i] = {static_cast<int>(i / 1000), static_cast<int>(i % 1000)};
+        labels[i] = "substring-key-" + std::to_string(i);
+    }
+
+    // Sliding windows over random lowercase text, the key shape of the substring counting engines.
+    std::mt19937 generator(42);
+    std::string text(count + 64, ' ');
+    for (char& symbol: text) {
+        symbol = static_cast<char>('a' + generator() % 26);
+    }
+    ArraySequence<ArraySequence<std::string_view>> windows;
+    for (const size_t length: {12, 16, 32, 64}) {
+        ArraySequence<std::string_view> views(count);
+        for (size_t i = 0; i < count; ++i) {
+            views[i] = std::string_view(text.data() + i, length);
+        }
+        windows.Append(views);
+    }
+
+    const char* headers[] = {
+            "hasher,key_set,keys,avg_key_bytes,ns_per_key,mb_per_s,checksum",
+            "hasher,key_set,keys,buckets,full_collisions,low_bucket_collisions,low_ratio,high_bucket_collisions,"
+            "high_ratio",
+            "hasher,key_set,distinct,capacity,avg_probe_length,status",
+    };
+
+    for (int section = 0; section < 3; ++section) {
+        std::cout << (section == 0 ? "" : "\n") << headers[section] << '\n';
+
+        benchmarkKeySet<size_t, FNV1a<size_t>>("FNV1a<size_t>", "sequential", sequential, section);
+        benchmarkKeySet<size_t, MurmurHash<size_t>>("MurmurHash<size_t>", "sequential", sequential, section);
+        benchmarkKeySet<size_t, std::hash<size_t>>("std::hash<size_t>", "sequential", sequential, section);
+        benchmarkKeySet<size_t, FNV1a<size_t>>("FNV1a<size_t>", "strided", strided, section);
+        benchmarkKeySet<size_t, MurmurHash<size_t>>("MurmurHash<size_t>", "strided", strided, section);
+        benchmarkKeySet<size_t, std::hash<size_t>>("std::hash<size_t>", "strided", strided, section);
+
+        benchmarkKeySet<double, FNV1a<double>>("FNV1a<double>", "halves", doubles, section);
+        benchmarkKeySet<double, MurmurHash<double>>("MurmurHash<double>", "halves", doubles, section);
+        benchmarkKeySet<double, std::hash<double>>("std::hash<double>", "halves", doubles, section);
+
+        benchmarkKeySet<const int*, FNV1a<const int*>>("FNV1a<pointer>", "array", pointers, section);
+        benchmarkKeySet<const int*, MurmurHash<const int*>>("MurmurHash<pointer>", "array", pointers, section);
+        benchmarkKeySet<const int*, std::hash<const int*>>("std::hash<pointer>", "array", pointers, section);
+
+        benchmarkKeySet<std::pair<int, int>, std::hash<std::pair<int, int>>>("std::hash<pair>", "grid", pairs,
+                                                                              section);
+
+        benchmarkKeySet<std::string, FNV1a<std::string>>("FNV1a<string>", "labels", labels, section);
+        benchmarkKeySet<std::string, MurmurHash<std::string>>("MurmurHash<string>", "labels", labels, section);
+        benchmarkKeySet<std::string, Crc32Hash<std::string>>("Crc32Hash<string>", "labels", labels, section);
+        benchmarkKeySet<std::string, std::hash<std::string>>("std::hash<string>", "labels", labels, section);
+
+        for (const auto& views: windows) {
+            const std::string keySet = "substrings" + std::to_string(views[0].size());
+            benchmarkKeySet<std::string_view, FNV1a<std::string_view>>("FNV1a<string_view>", keySet, views,
+                                                                        section);
+            benchmarkKeySet<std::string_view, MurmurHash<std::string_view>>("MurmurHash<string_view>", keySet,
+                                                                              views, section);
+            benchmarkKeySet<std::string_view, Crc32Hash<std::string_view>>("Crc32Hash<string_view>", keySet, views,
+                                                                             section);
+            benchmarkKeySet<std::string_view, std::hash<std::string_view>>("std::hash<string_view>", keySet,
+                                                                             views, section);
+        }
+    }
+
+    std::cout << "\nhasher,input_bits,mean_flip_probability,max_bias\n";
+    benchmarkAvalanche<FNV1a<size_t>, 8>("FNV1a<size_t>", loadValue<size_t>);
+    benchmarkAvalanche<MurmurHash<size_t>, 8>("MurmurHash<size_t>", loadValue<size_t>);
+    benchmarkAvalanche<std::hash<size_t>, 8>("std::hash<size_t>", loadValue<size_t>);
+    benchmarkAvalanche<FNV1a<double>, 8>("FNV1a<double>", loadValue<double>);
+    benchmarkAvalanche<MurmurHash<double>, 8>("MurmurHash<double>", loadValue<double>);
+    benchmarkAvalanche<MurmurHash<const int*>, 8>("MurmurHash<pointer>", [](const unsigned char* bytes) {
+        return reinterpret_cast<const int*>(loadValue<std::uintptr_t>(bytes));
+    });
+    benchmarkAvalanche<std::hash<std::pair<int, int>>, 8>(
+            "std::hash<pair>", [](const unsigned char* bytes) {
+                return std::pair(loadValue<int>(bytes), loadValue<int>(bytes + sizeof(int)));
+            });
+    auto makeString = [](const unsigned char* bytes) {
+        return std::string_view(reinterpret_cast<const char*>(bytes), 16);
+    };
+    benchmarkAvalanche<FNV1a<std::string_view>, 16>("FNV1a<string_view>", makeString);
+    benchmarkAvalanche<MurmurHash<std::string_view>, 16>("MurmurHash<string_view>", makeString);
+    benchmarkAvalanche<Crc32Hash<std::string_view>, 16>("Crc32Hash<string_view>", makeString);
+    benchmarkAvalanche<std::hash<std::string_view>, 16>("std::hash<string_view>", makeString);
+
+    return 0;
+}
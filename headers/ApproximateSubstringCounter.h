@@ -0,0 +1,63 @@
+#ifndef APPROXIMATESUBSTRINGCOUNTER_H
+#define APPROXIMATESUBSTRINGCOUNTER_H
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "../../sequences/arraySequence.h"
+#include "CountMinSketch.h"
+#include "FNV1aHash.h"
+#include "IDictionary.h"
+#include "StringArena.h"
+
+// Approximate top-K substrings per length in fixed memory. Every window is added to one Count-Min sketch; a
+// window whose estimate exceeds the threshold of its length enters that length's candidate table, which is cut
+// back to the K best estimates whenever it doubles. Memory is the sketch plus at most 2K candidates per length,
+// however large the text. Reported counts are sketch estimates: never below the true count and, with
+// probability at least 1 - GetDelta(), at most GetErrorBound() above it.
+class ApproximateSubstringCounter final {
+    using Sketch = CountMinSketch<std::string_view>;
+    using CandidateTable = IDictionary<std::string_view, size_t, FNV1a<std::string_view>>;
+
+    size_t lmin;
+    size_t lmax;
+    size_t k;
+    Sketch sketch;
+    // Candidate keys of all lengths share one arena, which is compacted when pruning has left it mostly garbage.
+    ArraySequence<CandidateTable> candidates;
+    ArraySequence<size_t> thresholds;
+    StringArena arena;
+    size_t liveBytes = 0;
+    std::string pending;
+    size_t totalBytes = 0;
+
+    void CountWindows(std::string_view text, size_t startEnd);
+    void Prune(size_t length);
+    void Compact();
+
+public:
+    ApproximateSubstringCounter(size_t lmin, size_t lmax, size_t k, double epsilon, double delta);
+
+    void Feed(std::string_view chunk);
+
+    // Top k substrings of every length in [lmin, lmax], most frequent first.
+    ArraySequence<ArraySequence<std::pair<std::string, size_t>>> Finish();
+
+    size_t GetTotalBytes() const { return totalBytes; }
+
+    size_t GetTotalWindows() const { return sketch.GetTotal(); }
+
+    size_t GetSketchBytes() const { return sketch.GetBytes(); }
+
+    size_t GetSketchWidth() const { return sketch.GetWidth(); }
+
+    size_t GetSketchDepth() const { return sketch.GetDepth(); }
+
+    double GetEpsilon() const { return sketch.GetEpsilon(); }
+
+    double GetDelta() const { return sketch.GetDelta(); }
+
+    size_t GetErrorBound() const { return sketch.GetErrorBound(); }
+};
+
+#endif // APPROXIMATESUBSTRINGCOUNTER_H
@@ -0,0 +1,123 @@
+#ifndef CATEGORYTABLE_H
+#define CATEGORYTABLE_H
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "IDictionary.h"
+#include "MurmurHash.h"
+
+// Loads up to eight bytes little-endian; the common full-word case is a single unaligned load at run time.
+constexpr uint64_t loadPrefix(const char* data, const size_t count) {
+    if (count == 8 && !std::is_constant_evaluated()) {
+        return murmurLoad64(data);
+    }
+    uint64_t word = 0;
+    for (size_t i = 0; i < count; ++i) {
+        word |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << i * 8;
+    }
+    return word;
+}
+
+// Perfect hash over a fixed key set. Keys are reduced to a constant-time signature (length plus the first and last
+// eight bytes) and the seed is searched at compile time until every key lands in its own slot, so a lookup is two
+// loads, one multiply, one table read and one comparison. The key set must have distinct signatures.
+template<size_t N>
+struct PerfectHash {
+    static constexpr size_t slotCount = std::bit_ceil(N * 4);
+    static constexpr int shift = 64 - std::countr_zero(slotCount);
+    static_assert(N < 255, "PerfectHash stores key indices in one byte");
+
+    std::array<std::string_view, N> keys{};
+    std::array<uint8_t, slotCount> slots{};
+    uint64_t seed = 0;
+
+    static constexpr uint64_t Signature(const std::string_view key) {
+        const size_t width = key.size() < 8 ? key.size() : 8;
+        const uint64_t head = loadPrefix(key.data(), width);
+        const uint64_t tail = loadPrefix(key.data() + key.size() - width, width);
+        return head ^ std::rotl(tail, 29) ^ key.size() * 0x9e3779b97f4a7c15ULL;
+    }
+
+    constexpr size_t Slot(const std::string_view key) const {
+        return (Signature(key) ^ seed) * 0xff51afd7ed558ccdULL >> shift;
+    }
+
+    // Index of key in the key set, or N for a key outside it.
+    constexpr size_t IndexOf(const std::string_view key) const {
+        const uint8_t slot = slots[Slot(key)];
+        return slot != 0 && keys[slot - 1] == key ? slot - 1 : N;
+    }
+};
+
+template<size_t N>
+consteval PerfectHash<N> makePerfectHash(const std::array<std::string_view, N>& keys) {
+    PerfectHash<N> hash;
+    hash.keys = keys;
+
+    for (;; ++hash.seed) {
+        hash.slots = {};
+        bool placed = true;
+        for (size_t i = 0; i < N && placed; ++i) {
+            uint8_t& slot = hash.slots[hash.Slot(keys[i])];
+            placed = slot == 0;
+            slot = static_cast<uint8_t>(i + 1);
+        }
+        if (placed) {
+            return hash;
+        }
+    }
+}
+
+// Counter over a category set known at compile time. Known categories are a dense array increment; values
+// outside the set still get counted, in a regular dictionary.
+template<const auto& Categories>
+class CategoryCounter final {
+    static constexpr size_t categoryCount = Categories.size();
+    static constexpr PerfectHash<categoryCount> hash = makePerfectHash(Categories);
+
+    std::array<size_t, categoryCount> counts{};
+    IDictionary<std::string, size_t> others;
+
+public:
+    void Add(const std::string_view category) {
+        if (const size_t index = hash.IndexOf(category); index < categoryCount) {
+            ++counts[index];
+        } else {
+            ++others.FindOrInsert(std::string(category), 0);
+        }
+    }
+
+    size_t Get(const std::string_view category) const {
+        if (const size_t index = hash.IndexOf(category); index < categoryCount) {
+            return counts[index];
+        }
+        const std::string key(category);
+        return others.Contains(key) ? others.Get(key) : 0;
+    }
+
+    void Merge(const CategoryCounter& other) {
+        for (size_t i = 0; i < categoryCount; ++i) {
+            counts[i] += other.counts[i];
+        }
+        if (other.others.GetCount() > 0) {
+            IDictionary<std::string, size_t> extra = other.others;
+            for (const auto& [category, count]: extra) {
+                others.FindOrInsert(category, 0) += count;
+            }
+        }
+    }
+
+    IDictionary<std::string, size_t> ToDictionary() const {
+        IDictionary<std::string, size_t> result = others;
+        for (size_t i = 0; i < categoryCount; ++i) {
+            result.Insert(std::string(Categories[i]), counts[i]);
+        }
+        return result;
+    }
+};
+
+#endif // CATEGORYTABLE_H
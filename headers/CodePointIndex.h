@@ -0,0 +1,77 @@
+#ifndef CODEPOINTINDEX_H
+#define CODEPOINTINDEX_H
+#include <algorithm>
+#include <string_view>
+
+#include "../../sequences/arraySequence.h"
+
+// Byte offsets of the UTF-8 code points of a text, so a window of code points is sliced in O(1).
+// A code point starts at every byte that is not a continuation byte (10xxxxxx) and runs up to the next one;
+// malformed sequences therefore still split the text deterministically, and every counting engine splits them
+// the same way. Continuation bytes before the first lead byte belong to no code point.
+class CodePointIndex final {
+    std::string_view text;
+    ArraySequence<size_t> offsets;
+    bool wellFormed = true;
+    size_t longest = 0;
+
+public:
+    static bool IsContinuation(const char byte) { return (static_cast<unsigned char>(byte) & 0xC0) == 0x80; }
+
+    // Continuation bytes a lead byte announces; bytes that cannot lead a sequence announce none.
+    static size_t ContinuationsAfter(const char byte) {
+        const auto lead = static_cast<unsigned char>(byte);
+        return (lead & 0xE0) == 0xC0 ? 1 : (lead & 0xF0) == 0xE0 ? 2 : (lead & 0xF8) == 0xF0 ? 3 : 0;
+    }
+
+    // Number of code points in a substring that starts at a code point boundary.
+    static size_t LengthOf(const std::string_view bytes) {
+        size_t length = 0;
+        for (const char byte: bytes) {
+            length += !IsContinuation(byte);
+        }
+        return length;
+    }
+
+    explicit CodePointIndex(const std::string_view text) : text(text), offsets(LengthOf(text) + 1) {
+        size_t index = 0;
+        size_t expected = 0;
+        for (size_t position = 0; position < text.size(); ++position) {
+            if (IsContinuation(text[position])) {
+                if (expected == 0) {
+                    wellFormed = false;
+                } else {
+                    --expected;
+                }
+            } else {
+                wellFormed = wellFormed && expected == 0;
+                expected = ContinuationsAfter(text[position]);
+                offsets[index++] = position;
+            }
+        }
+        offsets[index] = text.size();
+        wellFormed = wellFormed && expected == 0;
+        for (size_t codePoint = 0; codePoint < index; ++codePoint) {
+            longest = std::max(longest, offsets[codePoint + 1] - offsets[codePoint]);
+        }
+    }
+
+    std::string_view GetText() const { return text; }
+
+    // Every lead byte is followed by exactly the continuation bytes it announces. Overlong forms and surrogates
+    // are not checked, since they do not change where code points split.
+    bool IsWellFormed() const { return wellFormed; }
+
+    // Bytes in the longest code point: at most four in well-formed UTF-8, unbounded otherwise.
+    size_t GetLongestCodePoint() const { return longest; }
+
+    size_t GetLength() const { return offsets.GetLength() - 1; }
+
+    size_t GetOffset(const size_t index) const { return offsets[index]; }
+
+    std::string_view Slice(const size_t start, const size_t length) const {
+        return text.substr(offsets[start], offsets[start + length] - offsets[start]);
+    }
+};
+
+#endif // CODEPOINTINDEX_H
@@ -1,5 +1,8 @@
 #ifndef CONCEPTS_H
 #define CONCEPTS_H
+#include <string>
+#include <string_view>
+
 #include "TypeTraits.h"
 
 template<typename From, typename To>
@@ -40,7 +43,7 @@ template<typename T>
 concept Pointer = isPointerValue<T>;
 
 template<typename T>
-concept String = (sameAsValue<T, std::string> || sameAsValue<T, const char*>);
+concept String = (sameAsValue<T, std::string> || sameAsValue<T, std::string_view> || sameAsValue<T, const char*>);
 
 template<typename T>
 concept Numerical = Integer<T> || FloatingPoint<T>;
@@ -0,0 +1,114 @@
+#ifndef CONCURRENTDICTIONARY_H
+#define CONCURRENTDICTIONARY_H
+#include <memory>
+#include <mutex>
+
+#include "IDictionary.h"
+
+// Hash map for many concurrent writers: keys are spread over independently locked IDictionary stripes,
+// so threads only contend when they hit the same stripe and each stripe grows on its own while the rest
+// of the map stays available.
+template<typename TKey, typename TValue, typename Hasher = std::hash<TKey>>
+    requires Hashable<TKey, Hasher> && EqualityComparable<TKey>
+class ConcurrentDictionary final {
+    struct alignas(64) Stripe {
+        mutable std::mutex mutex;
+        IDictionary<TKey, TValue, Hasher> dictionary;
+    };
+
+    std::unique_ptr<Stripe[]> stripes;
+    size_t stripeCount;
+
+    static size_t RoundUpToPowerOfTwo(const size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    Stripe& StripeFor(const TKey& key) const { return stripes[(Hasher{}(key) >> 32) & (stripeCount - 1)]; }
+
+public:
+    explicit ConcurrentDictionary(const size_t stripeCount = 64, const size_t capacityPerStripe = 16,
+                                  const float maxLoadFactor = 0.9) :
+        stripes(std::make_unique<Stripe[]>(RoundUpToPowerOfTwo(stripeCount))),
+        stripeCount(RoundUpToPowerOfTwo(stripeCount)) {
+        for (size_t index = 0; index < this->stripeCount; ++index) {
+            stripes[index].dictionary = IDictionary<TKey, TValue, Hasher>(capacityPerStripe, maxLoadFactor);
+        }
+    }
+
+    ConcurrentDictionary(const ConcurrentDictionary&) = delete;
+
+    ConcurrentDictionary& operator=(const ConcurrentDictionary&) = delete;
+
+    void Insert(const TKey& key, const TValue& value) {
+        Stripe& stripe = StripeFor(key);
+        std::lock_guard lock(stripe.mutex);
+        stripe.dictionary.Insert(key, value);
+    }
+
+    // Applies update to the value stored under key (inserting initial first if needed) while the stripe is locked
+    // and returns a copy of the result.
+    template<typename Update>
+    TValue Upsert(const TKey& key, Update&& update, const TValue& initial = TValue()) {
+        Stripe& stripe = StripeFor(key);
+        std::lock_guard lock(stripe.mutex);
+        return stripe.dictionary.Upsert(key, std::forward<Update>(update), initial);
+    }
+
+    TValue Add(const TKey& key, const TValue& delta) {
+        return Upsert(key, [&delta](TValue& value) { value += delta; });
+    }
+
+    TValue Get(const TKey& key) const {
+        Stripe& stripe = StripeFor(key);
+        std::lock_guard lock(stripe.mutex);
+        return stripe.dictionary.Get(key);
+    }
+
+    bool Contains(const TKey& key) const {
+        Stripe& stripe = StripeFor(key);
+        std::lock_guard lock(stripe.mutex);
+        return stripe.dictionary.Contains(key);
+    }
+
+    void Remove(const TKey& key) {
+        Stripe& stripe = StripeFor(key);
+        std::lock_guard lock(stripe.mutex);
+        stripe.dictionary.Remove(key);
+    }
+
+    size_t GetCount() const {
+        size_t count = 0;
+        for (size_t index = 0; index < stripeCount; ++index) {
+            std::lock_guard lock(stripes[index].mutex);
+            count += stripes[index].dictionary.GetCount();
+        }
+        return count;
+    }
+
+    size_t GetStripeCount() const { return stripeCount; }
+
+    // Visits every entry one stripe at a time; the visited stripe is locked for the duration of its visit.
+    template<typename Visitor>
+    void ForEach(Visitor&& visit) {
+        for (size_t index = 0; index < stripeCount; ++index) {
+            std::lock_guard lock(stripes[index].mutex);
+            for (auto& [key, value]: stripes[index].dictionary) {
+                visit(key, value);
+            }
+        }
+    }
+
+    IDictionary<TKey, TValue, Hasher> Snapshot() {
+        IDictionary<TKey, TValue, Hasher> result;
+        ForEach([&result](const TKey& key, const TValue& value) { result.Insert(key, value); });
+        return result;
+    }
+
+    ~ConcurrentDictionary() = default;
+};
+
+#endif // CONCURRENTDICTIONARY_H
@@ -0,0 +1,95 @@
+#ifndef COUNTMINSKETCH_H
+#define COUNTMINSKETCH_H
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#include "../../sequences/arraySequence.h"
+#include "FNV1aHash.h"
+#include "MurmurHash.h"
+
+// Count-Min sketch with conservative update. Row i indexes its counters with h1 + i * h2, where h1 and h2 come
+// from two independent hash families, so depth rows cost two hash computations per key. With width >= e / epsilon
+// and depth >= ln(1 / delta), an estimate never undercounts and exceeds the true count by more than
+// epsilon * GetTotal() with probability at most delta. Counters saturate at 2^32 - 1.
+template<typename TKey, typename Hash1 = FNV1a<TKey>, typename Hash2 = MurmurHash<TKey>>
+class CountMinSketch final {
+    using Counter = uint32_t;
+
+    ArraySequence<Counter> counters;
+    size_t width;
+    size_t depth;
+    size_t mask;
+    size_t total;
+
+    static size_t RoundUpToPowerOfTwo(const size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    size_t Index(const size_t row, const size_t h1, const size_t h2) const {
+        return row * width + ((h1 + row * h2) & mask);
+    }
+
+public:
+    CountMinSketch(const double epsilon, const double delta) : width(0), depth(0), mask(0), total(0) {
+        if (!(epsilon > 0 && epsilon < 1) || !(delta > 0 && delta < 1)) {
+            throw std::invalid_argument("Sketch error and failure probability must lie in (0, 1)");
+        }
+        width = RoundUpToPowerOfTwo(static_cast<size_t>(std::ceil(std::exp(1.0) / epsilon)));
+        depth = static_cast<size_t>(std::ceil(std::log(1 / delta)));
+        mask = width - 1;
+        counters = ArraySequence<Counter>(width * depth);
+    }
+
+    // Adds count occurrences of key and returns its new estimate. Only the counters at the current minimum grow,
+    // which keeps the estimate an upper bound while adding less noise to the other keys.
+    size_t Add(const TKey& key, const size_t count = 1) {
+        const size_t h1 = Hash1{}(key);
+        const size_t h2 = Hash2{}(key) | 1;
+        total += count;
+
+        size_t estimate = std::numeric_limits<Counter>::max();
+        for (size_t row = 0; row < depth; ++row) {
+            estimate = std::min<size_t>(estimate, counters[Index(row, h1, h2)]);
+        }
+        const auto updated =
+                static_cast<Counter>(std::min<size_t>(estimate + count, std::numeric_limits<Counter>::max()));
+        for (size_t row = 0; row < depth; ++row) {
+            Counter& counter = counters[Index(row, h1, h2)];
+            counter = std::max(counter, updated);
+        }
+        return updated;
+    }
+
+    size_t Estimate(const TKey& key) const {
+        const size_t h1 = Hash1{}(key);
+        const size_t h2 = Hash2{}(key) | 1;
+        size_t estimate = std::numeric_limits<Counter>::max();
+        for (size_t row = 0; row < depth; ++row) {
+            estimate = std::min<size_t>(estimate, counters[Index(row, h1, h2)]);
+        }
+        return estimate;
+    }
+
+    size_t GetWidth() const { return width; }
+
+    size_t GetDepth() const { return depth; }
+
+    size_t GetTotal() const { return total; }
+
+    size_t GetBytes() const { return width * depth * sizeof(Counter); }
+
+    // Error and failure probability actually guaranteed by the rounded-up dimensions.
+    double GetEpsilon() const { return std::exp(1.0) / static_cast<double>(width); }
+
+    double GetDelta() const { return std::exp(-static_cast<double>(depth)); }
+
+    size_t GetErrorBound() const { return static_cast<size_t>(std::ceil(GetEpsilon() * static_cast<double>(total))); }
+};
+
+#endif // COUNTMINSKETCH_H
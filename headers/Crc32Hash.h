@@ -0,0 +1,98 @@
+#ifndef CRC32HASH_H
+#define CRC32HASH_H
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "Concepts.h"
+#include "MurmurHash.h"
+
+#if defined(__SSE4_2__) || defined(__AVX__)
+#include <nmmintrin.h>
+#define CRC32HASH_SSE42 1
+#endif
+
+// CRC32C (Castagnoli) without pre/post inversion, matching the SSE4.2 crc32 instruction.
+namespace crc32c {
+    constexpr std::array<uint32_t, 256> makeTable() {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = crc & 1 ? crc >> 1 ^ 0x82f63b78U : crc >> 1;
+            }
+            table[i] = crc;
+        }
+        return table;
+    }
+
+    inline constexpr std::array<uint32_t, 256> table = makeTable();
+
+    inline uint32_t update8(const uint32_t crc, const unsigned char byte) {
+#ifdef CRC32HASH_SSE42
+        return _mm_crc32_u8(crc, byte);
+#else
+        return table[(crc ^ byte) & 0xFF] ^ crc >> 8;
+#endif
+    }
+
+    inline uint32_t update64(uint32_t crc, const uint64_t word) {
+#if defined(CRC32HASH_SSE42) && defined(__x86_64__)
+        return static_cast<uint32_t>(_mm_crc32_u64(crc, word));
+#elif defined(CRC32HASH_SSE42)
+        // 32-bit x86 has no 64-bit crc32; two 32-bit steps over the little-endian halves give the same CRC.
+        crc = _mm_crc32_u32(crc, static_cast<uint32_t>(word));
+        return _mm_crc32_u32(crc, static_cast<uint32_t>(word >> 32));
+#else
+        for (int i = 0; i < 8; ++i) {
+            crc = table[(crc ^ word >> i * 8) & 0xFF] ^ crc >> 8;
+        }
+        return crc;
+#endif
+    }
+} // namespace crc32c
+
+// Two independent CRC32C lanes over alternating 8-byte words, folded into 64 bits and finalised with
+// the MurmurHash3 mixer so that both the low (slot) and high (fingerprint, stripe) bits are usable.
+inline uint64_t crc32Hash64(const char* data, const size_t length) {
+    uint32_t lowLane = 0x9e3779b9U;
+    uint32_t highLane = 0x7f4a7c15U;
+    size_t i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        uint64_t first;
+        uint64_t second;
+        std::memcpy(&first, data + i, sizeof(first));
+        std::memcpy(&second, data + i + 8, sizeof(second));
+        lowLane = crc32c::update64(lowLane, first);
+        highLane = crc32c::update64(highLane, second);
+    }
+    if (i + 8 <= length) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        lowLane = crc32c::update64(lowLane, word);
+        i += 8;
+    }
+    for (; i < length; ++i) {
+        highLane = crc32c::update8(highLane, static_cast<unsigned char>(data[i]));
+    }
+
+    return murmurMix64((static_cast<uint64_t>(highLane) << 32 | lowLane) ^ length * 0x9e3779b97f4a7c15ULL);
+}
+
+template<typename T>
+struct Crc32Hash {
+    size_t operator()(const T&) const = delete;
+};
+
+template<String T>
+struct Crc32Hash<T> {
+    size_t operator()(const T& key) const {
+        const std::string_view view(key);
+        return crc32Hash64(view.data(), view.size());
+    }
+};
+
+#endif // CRC32HASH_H
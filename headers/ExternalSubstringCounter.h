@@ -0,0 +1,59 @@
+#ifndef EXTERNALSUBSTRINGCOUNTER_H
+#define EXTERNALSUBSTRINGCOUNTER_H
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "../../sequences/arraySequence.h"
+#include "FNV1aHash.h"
+#include "IDictionary.h"
+#include "StringArena.h"
+
+// Exact substring counter for texts and tables that do not fit in memory. The text arrives in consecutive
+// chunks; windows are counted into an arena-backed IDictionary sized to the memory budget, and whenever the
+// table or the arena fills up its entries are written to disk as a run sorted by key. Finish merges the runs
+// and visits every distinct substring with length in [lmin, lmax] once, in lexicographic byte order.
+class ExternalSubstringCounter final {
+    using Table = IDictionary<std::string_view, size_t, FNV1a<std::string_view>>;
+
+    size_t lmin;
+    size_t lmax;
+    size_t entryLimit;
+    size_t arenaLimit;
+    std::filesystem::path spillDirectory;
+    Table table;
+    StringArena arena;
+    std::string pending;
+    ArraySequence<std::filesystem::path> runs;
+    size_t runsCreated = 0;
+    size_t totalBytes = 0;
+
+    void CountWindows(std::string_view text, size_t startEnd);
+    void Spill();
+    std::filesystem::path NextRunPath();
+    void MergeRuns(const ArraySequence<std::filesystem::path>& group,
+                   const std::function<void(std::string_view, size_t)>& visit) const;
+
+public:
+    // Runs are merged at most this many at a time; more runs are first merged into intermediate runs.
+    static constexpr size_t mergeFanIn = 64;
+
+    ExternalSubstringCounter(size_t lmin, size_t lmax, size_t memoryBudget,
+                             const std::filesystem::path& temporaryDirectory = std::filesystem::temp_directory_path());
+
+    ExternalSubstringCounter(const ExternalSubstringCounter&) = delete;
+    ExternalSubstringCounter& operator=(const ExternalSubstringCounter&) = delete;
+
+    ~ExternalSubstringCounter();
+
+    void Feed(std::string_view chunk);
+
+    void Finish(const std::function<void(std::string_view, size_t)>& visit);
+
+    size_t GetRunCount() const { return runsCreated; }
+
+    size_t GetTotalBytes() const { return totalBytes; }
+};
+
+#endif // EXTERNALSUBSTRINGCOUNTER_H
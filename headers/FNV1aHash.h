@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <cstring>
 #include <string>
+#include <string_view>
 
 #include "Concepts.h"
 
@@ -13,7 +14,7 @@ struct FNV1a {
 
 template<Integer T>
 struct FNV1a<T> {
-    size_t operator()(const T& key) const {
+    constexpr size_t operator()(const T& key) const {
         size_t hash = 0xcbf29ce484222325UL;
         T tmp = key;
         for (size_t i = 0; i < sizeof(T); ++i) {
@@ -47,12 +48,11 @@ struct FNV1a<T> {
 
 template<String T>
 struct FNV1a<T> {
-    size_t operator()(const T& key) const {
+    constexpr size_t operator()(const T& key) const {
         size_t hash = 0xcbf29ce484222325UL;
-        const char* data = key.c_str();
 
-        while (*data) {
-            hash ^= static_cast<size_t>(*data++);
+        for (const char symbol: std::string_view(key)) {
+            hash ^= static_cast<size_t>(symbol);
             hash *= 0x100000001b3UL;
         }
         return hash;
@@ -1,58 +1,110 @@
 #ifndef HISTOGRAM_H
 #define HISTOGRAM_H
+#include <array>
+#include <atomic>
+#include <cmath>
 #include <functional>
+#include <string_view>
 
 
 #include "../../sorting/DefaultComparators.h"
 #include "../../sorting/Person.h"
 #include "../../sorting/quickSort.h"
+#include "../headers/CategoryTable.h"
 #include "../headers/IDictionary.h"
+#include "../headers/KllSketch.h"
+#include "../headers/PairHash.h"
+#include "../headers/Parallel.h"
+#include "../headers/RangeIndex.h"
+#include "../headers/RunningStatistics.h"
+#include "../headers/Selection.h"
 
 
-template<typename T1, typename T2>
-struct std::hash<std::pair<T1, T2>> {
-    std::size_t operator()(const std::pair<T1, T2>& p) const {
-        std::size_t h1 = std::hash<T1>{}(p.first);
-        std::size_t h2 = std::hash<T2>{}(p.second);
+inline constexpr std::array<std::string_view, 2> genderCategories{"Мужчина", "Женщина"};
+inline constexpr std::array<std::string_view, 6> educationCategories{
+        "Основное общее", "Среднее общее", "Среднее профессиональное", "Бакалавриат", "Магистратура", "Аспирантура"};
+inline constexpr std::array<std::string_view, 4> maritalStatusCategories{"В браке", "Не в браке", "В разводе",
+                                                                         "Вдовец/Вдова"};
 
-        return h1 ^ (h2 << 1);
+// Values of one numeric field with their moments accumulated as the values arrive. A column built with a
+// non-zero sketch size keeps a KLL sketch instead of the values, so its quantiles are approximate but its memory
+// is bounded; otherwise the values are kept in input order and quantiles are exact.
+struct NumericColumn {
+    ArraySequence<int> values;
+    RunningStatistics moments;
+    KllSketch<int> sketch;
+
+    explicit NumericColumn(const size_t sketchK = 0) : sketch(sketchK) {}
+
+    bool IsSketched() const { return sketch.GetK() > 0; }
+
+    void Add(const int value) {
+        moments.Add(value);
+        if (IsSketched()) {
+            sketch.Add(value);
+        } else {
+            values.Append(value);
+        }
+    }
+
+    // Folds the moments and sketch of other, built with the same sketch size, into this column; the values are
+    // concatenated by the caller.
+    void Merge(const NumericColumn& other) {
+        moments.Merge(other.moments);
+        sketch.Merge(other.sketch);
+    }
+
+    // Value of rank ceil(q * n) among the n values; NaN for an empty column. The median averages the two middle
+    // values of an even-sized exact column.
+    double GetQuantile(const double q) const {
+        const size_t n = moments.GetCount();
+        if (n == 0) {
+            return std::nan("");
+        }
+        if (IsSketched()) {
+            return sketch.GetQuantile(q);
+        }
+        if (q == 0.5) {
+            return medianOf(values);
+        }
+        const auto rank = static_cast<size_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(n)));
+        return selectNth(values, std::max<size_t>(rank, 1) - 1);
     }
 };
 
 struct Partition {
-    ArraySequence<int> ages;
-    ArraySequence<int> weights;
-    ArraySequence<int> heights;
-    ArraySequence<int> salaries;
-    IDictionary<std::string, size_t> genders;
-    IDictionary<std::string, size_t> educations;
-    IDictionary<std::string, size_t> maritalStatuses;
+    NumericColumn ages;
+    NumericColumn weights;
+    NumericColumn heights;
+    NumericColumn salaries;
+    CategoryCounter<genderCategories> genders;
+    CategoryCounter<educationCategories> educations;
+    CategoryCounter<maritalStatusCategories> maritalStatuses;
 
-    Partition() {
-        genders.Insert("Мужчина", 0);
-        genders.Insert("Женщина", 0);
-        educations.Insert("Основное общее", 0);
-        educations.Insert("Среднее общее", 0);
-        educations.Insert("Среднее профессиональное", 0);
-        educations.Insert("Бакалавриат", 0);
-        educations.Insert("Магистратура", 0);
-        educations.Insert("Аспирантура", 0);
-        maritalStatuses.Insert("В браке", 0);
-        maritalStatuses.Insert("Не в браке", 0);
-        maritalStatuses.Insert("В разводе", 0);
-        maritalStatuses.Insert("Вдовец/Вдова", 0);
-    };
+    explicit Partition(const size_t sketchK = 0) :
+        ages(sketchK), weights(sketchK), heights(sketchK), salaries(sketchK) {}
 };
 
+// Population statistics; kurtosis is excess kurtosis. NaN where undefined, e.g. for an empty partition.
 struct Statistics {
     double median;
+    double p90;
+    double p99;
     double mean;
     double variance;
+    double standardDeviation;
+    double skewness;
+    double kurtosis;
+    double min;
+    double max;
 
     Statistics() = default;
 
-    Statistics(const double median, const double mean, const double variance) :
-        median(median), mean(mean), variance(variance) {}
+    explicit Statistics(const NumericColumn& column) :
+        median(column.GetQuantile(0.5)), p90(column.GetQuantile(0.9)), p99(column.GetQuantile(0.99)),
+        mean(column.moments.GetMean()), variance(column.moments.GetVariance()),
+        standardDeviation(column.moments.GetStandardDeviation()), skewness(column.moments.GetSkewness()),
+        kurtosis(column.moments.GetKurtosis()), min(column.moments.GetMin()), max(column.moments.GetMax()) {}
 };
 
 struct PartitionStatistics {
@@ -64,6 +116,8 @@ struct PartitionStatistics {
     IDictionary<std::string, size_t> educations;
     IDictionary<std::string, size_t> maritalStatuses;
 
+    // Raw column values in input order, or ascending when requested from GetStatistics. Empty when the
+    // histogram keeps quantile sketches instead of values.
     ArraySequence<int> agesData;
     ArraySequence<int> weightsData;
     ArraySequence<int> heightsData;
@@ -73,74 +127,134 @@ struct PartitionStatistics {
 class Histogram final {
     using Range = std::pair<int, int>;
     IDictionary<Range, Partition> partitions;
+    size_t sketchK = 0;
 
-    static Statistics CalculateStatisticsForField(const ArraySequence<int>& sequence) {
-        double median, mean = 0.0, variance = 0.0;
+    // Only the quantiles read the values or sketch; the moments were accumulated while the partition was built.
+    static Statistics CalculateStatisticsForField(const NumericColumn& column) { return Statistics(column); }
 
-        size_t n = sequence.GetLength();
-        if (n % 2 == 0) {
-            median = (sequence[n / 2 - 1] + sequence[n / 2]) / 2.0;
-        } else {
-            median = sequence[n / 2];
-        }
+    static constexpr size_t minPersonsPerWorker = size_t{1} << 14;
+    static constexpr std::array<NumericColumn Partition::*, 4> columns{
+            &Partition::ages, &Partition::weights, &Partition::heights, &Partition::salaries};
 
-        n = static_cast<double>(n);
-        for (int data: sequence) {
-            mean += data;
-        }
-        mean /= n;
+    static void AddPerson(Partition& partition, const Person& person) {
+        partition.ages.Add(person.getAge());
+        partition.weights.Add(person.getWeight());
+        partition.heights.Add(person.getHeight());
+        partition.salaries.Add(person.getSalary());
+        partition.genders.Add(person.getGender());
+        partition.educations.Add(person.getEducation());
+        partition.maritalStatuses.Add(person.getMaritalStatus());
+    }
 
-        for (int data: sequence) {
-            variance += std::pow(data - mean, 2);
-        }
-        variance /= n;
+    static constexpr std::array<ArraySequence<int> PartitionStatistics::*, 4> dataColumns{
+            &PartitionStatistics::agesData, &PartitionStatistics::weightsData, &PartitionStatistics::heightsData,
+            &PartitionStatistics::salariesData};
 
-        return {median, mean, variance};
-    }
+    // Sorts the given columns; the largest are handed out first so one long sort does not start last and hold
+    // up the others.
+    static void SortColumns(ArraySequence<ArraySequence<int>*>& tasks, const size_t workers) {
+        const size_t count = tasks.GetLength();
+        QuickSorter<ArraySequence<int>*> order;
+        order.Sort(tasks, [](ArraySequence<int>* const& left, ArraySequence<int>* const& right) {
+            return left->GetLength() > right->GetLength();
+        });
 
-    Range getRange(const int field, const ArraySequence<Range>& ranges) {
-        for (const auto& range: ranges) {
-            if (field >= range.first && field < range.second) {
-                return range;
+        std::atomic<size_t> next{0};
+        parallelFor(std::max<size_t>(1, std::min(workers, count)), [&](size_t) {
+            QuickSorter<int> sorter;
+            for (size_t task = next++; task < count; task = next++) {
+                sorter.Sort(*tasks[task], ascendingComparator);
             }
-        }
-        return {-1, -1};
+        });
     }
 
 public:
-    Histogram() = default;
+    // quantileError 0 keeps every value and gives exact quantiles. A rank error in (0, 1) keeps a KLL sketch per
+    // numeric field instead, whose quantiles are off by at most that fraction of the partition size in rank.
+    explicit Histogram(const double quantileError = 0.0) :
+        sketchK(quantileError == 0.0 ? 0 : KllSketch<int>::KForRankError(quantileError)) {}
 
+    // Throws std::invalid_argument for empty or overlapping ranges; persons outside every range are skipped.
+    // threadCount 0 uses every hardware thread; small inputs are built on fewer threads.
     void Build(const ArraySequence<Person>& persons, const ArraySequence<Range>& ranges,
-              const std::function<int(const Person&)>& field) {
+              const std::function<int(const Person&)>& field, const size_t threadCount = 0) {
+        const RangeIndex index(ranges);
+        const size_t rangeCount = ranges.GetLength();
+
         for (const auto& range: ranges) {
-            partitions.Insert(range, Partition());
+            partitions.Insert(range, Partition(sketchK));
+        }
+        // No insertions follow, so the slots stay put and each person costs one index lookup.
+        ArraySequence<Partition*> targets(rangeCount);
+        for (size_t position = 0; position < rangeCount; ++position) {
+            targets[position] = &partitions[ranges[position]];
         }
 
-        for (const auto& person: persons) {
-            const int partitionField = field(person);
-            Range range = std::move(getRange(partitionField, ranges));
-            if (range.first != -1 && range.second != -1) {
-                Partition& partition = partitions[range];
-                partition.ages.Append(person.getAge());
-                partition.weights.Append(person.getWeight());
-                partition.heights.Append(person.getHeight());
-                partition.salaries.Append(person.getSalary());
-                ++partition.genders[person.getGender()];
-                ++partition.educations[person.getEducation()];
-                ++partition.maritalStatuses[person.getMaritalStatus()];
+        const size_t personCount = persons.GetLength();
+        const size_t workers =
+                std::max<size_t>(1, std::min(resolveThreadCount(threadCount), personCount / minPersonsPerWorker));
+
+        auto fill = [&](const size_t begin, const size_t end, auto&& partitionAt) {
+            for (size_t i = begin; i < end; ++i) {
+                const Person& person = persons[i];
+                const size_t position = index.Find(field(person));
+                if (position != RangeIndex::npos) {
+                    AddPerson(partitionAt(position), person);
+                }
             }
-        }
+        };
 
-        QuickSorter<int> sorter;
-        for (auto& [range, partition]: partitions) {
-            sorter.Sort(partition.ages, ascendingComparator);
-            sorter.Sort(partition.weights, ascendingComparator);
-            sorter.Sort(partition.heights, ascendingComparator);
-            sorter.Sort(partition.salaries, ascendingComparator);
+        if (workers == 1) {
+            fill(0, personCount, [&](const size_t position) -> Partition& { return *targets[position]; });
+        } else {
+            // Worker w fills partials for the contiguous block [w * chunk, (w + 1) * chunk) of persons, so
+            // concatenating the partials in worker order keeps every column in input order.
+            const size_t chunk = (personCount + workers - 1) / workers;
+            ArraySequence<ArraySequence<Partition>> partials(workers);
+            parallelFor(workers, [&](const size_t worker) {
+                ArraySequence<Partition> local(rangeCount);
+                for (auto& partition: local) {
+                    partition = Partition(sketchK);
+                }
+                fill(std::min(personCount, worker * chunk), std::min(personCount, (worker + 1) * chunk),
+                     [&](const size_t position) -> Partition& { return local[position]; });
+                partials[worker] = std::move(local);
+            });
+
+            parallelFor(workers, [&](const size_t worker) {
+                for (size_t position = worker; position < rangeCount; position += workers) {
+                    Partition& target = *targets[position];
+                    for (const auto column: columns) {
+                        size_t total = 0;
+                        for (size_t part = 0; part < workers; ++part) {
+                            total += (partials[part][position].*column).values.GetLength();
+                        }
+                        ArraySequence<int> merged(total);
+                        size_t offset = 0;
+                        for (size_t part = 0; part < workers; ++part) {
+                            const NumericColumn& partial = partials[part][position].*column;
+                            for (const int value: partial.values) {
+                                merged[offset++] = value;
+                            }
+                            (target.*column).Merge(partial);
+                        }
+                        (target.*column).values = std::move(merged);
+                    }
+                    for (size_t part = 0; part < workers; ++part) {
+                        Partition& partial = partials[part][position];
+                        target.genders.Merge(partial.genders);
+                        target.educations.Merge(partial.educations);
+                        target.maritalStatuses.Merge(partial.maritalStatuses);
+                        partial = Partition();
+                    }
+                }
+            });
         }
     }
 
-    IDictionary<Range, PartitionStatistics> GetStatistics() {
+    // Medians come from linear-time selection, so the columns are never sorted unless sortedData asks for the
+    // *Data copies in ascending order; those are then sorted on threadCount threads (0 uses every hardware thread).
+    IDictionary<Range, PartitionStatistics> GetStatistics(const bool sortedData = false, const size_t threadCount = 0) {
         IDictionary<Range, PartitionStatistics> result;
 
         for (const auto& [range, partition]: partitions) {
@@ -149,19 +263,40 @@ public:
             stats.weights = CalculateStatisticsForField(partition.weights);
             stats.heights = CalculateStatisticsForField(partition.heights);
             stats.salaries = CalculateStatisticsForField(partition.salaries);
-            stats.genders = partition.genders;
-            stats.educations = partition.educations;
-            stats.maritalStatuses = partition.maritalStatuses;
-            stats.agesData = partition.ages;
-            stats.weightsData = partition.weights;
-            stats.heightsData = partition.heights;
-            stats.salariesData = partition.salaries;
+            stats.genders = partition.genders.ToDictionary();
+            stats.educations = partition.educations.ToDictionary();
+            stats.maritalStatuses = partition.maritalStatuses.ToDictionary();
+            stats.agesData = partition.ages.values;
+            stats.weightsData = partition.weights.values;
+            stats.heightsData = partition.heights.values;
+            stats.salariesData = partition.salaries.values;
             result.Insert(range, stats);
         }
 
+        if (sortedData) {
+            ArraySequence<ArraySequence<int>*> tasks;
+            for (auto& [range, stats]: result) {
+                for (const auto column: dataColumns) {
+                    tasks.Append(&(stats.*column));
+                }
+            }
+            SortColumns(tasks, resolveThreadCount(threadCount));
+        }
+
         return result;
     }
 
+    // Arbitrary quantile q in [0, 1] of one numeric field, e.g. &Partition::salaries, within the given range.
+    double GetQuantile(const Range& range, NumericColumn Partition::* const column, const double q) const {
+        const Partition* partition = partitions.Find(range);
+        if (partition == nullptr) {
+            throw std::runtime_error("Unknown range");
+        }
+        return (partition->*column).GetQuantile(q);
+    }
+
+    bool IsSketched() const { return sketchK > 0; }
+
     ~Histogram() = default;
 };
 
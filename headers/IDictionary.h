@@ -1,163 +1,471 @@
 #ifndef IDICTIONARY_H
 #define IDICTIONARY_H
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
 #include "../../sequences/arraySequence.h"
 #include "Concepts.h"
 
+// IDICTIONARY_SIMD selects the SSE2 group probe where SSE2 is available; IDICTIONARY_SCALAR overrides it, so one
+// build can also test the scalar probe.
+#if defined(IDICTIONARY_SIMD) && !defined(IDICTIONARY_SCALAR) && defined(__SSE2__)
+#include <emmintrin.h>
+#define IDICTIONARY_SSE2 1
+#endif
+
 template<typename TKey, typename TValue, typename Hasher = std::hash<TKey>>
     requires Hashable<TKey, Hasher> && EqualityComparable<TKey>
 class IDictionary final {
-    struct Entry {
-        std::pair<TKey, TValue> keyValue;
-        size_t distance = 0;
-        bool occupied = false;
+    using KeyValue = std::pair<TKey, TValue>;
+
+    static constexpr uint8_t emptyControl = 0;
+    static constexpr uint8_t saturatedControl = 255;
+    static constexpr size_t groupWidth = 16;
+
+    static uint8_t Fingerprint(const size_t hash) { return static_cast<uint8_t>(hash >> (8 * sizeof(size_t) - 8)); }
+
+    // Probe metadata is kept apart from the key/value slots, so a probe mostly scans dense byte arrays.
+    // control[i] is 0 for an empty slot and min(distance + 1, 255) otherwise; a saturated distance is
+    // recomputed from the stored hash. fingerprints[i] holds the top hash byte and filters key comparisons.
+    // Both byte arrays repeat their first groupWidth - 1 entries past the end, so a group load never wraps.
+    struct Table {
+        ArraySequence<uint8_t> control;
+        ArraySequence<uint8_t> fingerprints;
+        ArraySequence<size_t> hashes;
+        ArraySequence<KeyValue> slots;
+        size_t capacity = 0;
+        size_t mask = 0;
+
+        Table() = default;
+
+        explicit Table(const size_t capacity) :
+            control(capacity + groupWidth), fingerprints(capacity + groupWidth), hashes(capacity), slots(capacity),
+            capacity(capacity), mask(capacity - 1) {}
+
+        bool Occupied(const size_t index) const { return control[index] != emptyControl; }
+
+        size_t Distance(const size_t index) const {
+            const uint8_t value = control[index];
+            return value != saturatedControl ? value - 1 : (index - (hashes[index] & mask)) & mask;
+        }
+
+        void SetMetadata(const size_t index, const uint8_t controlByte, const uint8_t fingerprint) {
+            control[index] = controlByte;
+            fingerprints[index] = fingerprint;
+            if (index < groupWidth - 1) {
+                control[capacity + index] = controlByte;
+                fingerprints[capacity + index] = fingerprint;
+            }
+        }
+
+        void SetSlot(const size_t index, const size_t hash, const size_t distance) {
+            hashes[index] = hash;
+            SetMetadata(index, distance < saturatedControl - 1 ? static_cast<uint8_t>(distance + 1) : saturatedControl,
+                        Fingerprint(hash));
+        }
+
+        // Returns true and the slot of the key if it is present. Otherwise index and distance describe
+        // the slot where Robin Hood insertion of the key has to start.
+        bool ProbeScalar(const TKey& key, const size_t hash, size_t& index, size_t& distance) const {
+            const uint8_t fingerprint = Fingerprint(hash);
+            index = hash & mask;
+            distance = 0;
+
+            while (Occupied(index) && Distance(index) >= distance) {
+                if (fingerprints[index] == fingerprint && hashes[index] == hash && slots[index].first == key) {
+                    return true;
+                }
+
+                ++distance;
+                index = (index + 1) & mask;
+            }
+            return false;
+        }
+
+#ifdef IDICTIONARY_SSE2
+        // Checks groupWidth slots per step: a slot ends the probe when its control byte is below
+        // probe distance + 1, and only slots before that point whose fingerprint matches compare keys.
+        bool Probe(const TKey& key, const size_t hash, size_t& index, size_t& distance) const {
+            const __m128i fingerprint = _mm_set1_epi8(static_cast<char>(Fingerprint(hash)));
+            const __m128i saturated = _mm_set1_epi8(static_cast<char>(saturatedControl));
+            const __m128i offsets = _mm_setr_epi8(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16);
+            size_t position = hash & mask;
+
+            index = position;
+            distance = 0;
+            if (!Occupied(position)) {
+                return false;
+            }
+            if (fingerprints[position] == Fingerprint(hash) && hashes[position] == hash &&
+                slots[position].first == key) {
+                return true;
+            }
+
+            for (size_t groupDistance = 0;; groupDistance += groupWidth) {
+                const __m128i controlBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&control[position]));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(controlBytes, saturated)) != 0) {
+                    return ProbeScalar(key, hash, index, distance);
+                }
+
+                const __m128i expected = _mm_adds_epu8(
+                        _mm_set1_epi8(static_cast<char>(std::min<size_t>(groupDistance, saturatedControl))), offsets);
+                const auto below = static_cast<unsigned>(
+                        ~_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(controlBytes, expected), controlBytes)) &
+                        0xFFFF);
+                const size_t stop = below != 0 ? static_cast<size_t>(__builtin_ctz(below)) : groupWidth;
+
+                const __m128i fingerprintBytes =
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&fingerprints[position]));
+                auto candidates =
+                        static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(fingerprintBytes, fingerprint)));
+                candidates &= (1u << stop) - (groupDistance == 0 ? 2u : 1u);
+
+                while (candidates != 0) {
+                    const size_t offset = __builtin_ctz(candidates);
+                    const size_t slot = (position + offset) & mask;
+                    if (hashes[slot] == hash && slots[slot].first == key) {
+                        index = slot;
+                        distance = groupDistance + offset;
+                        return true;
+                    }
+                    candidates &= candidates - 1;
+                }
+
+                if (stop < groupWidth) {
+                    index = (position + stop) & mask;
+                    distance = groupDistance + stop;
+                    return false;
+                }
+
+                position = (position + groupWidth) & mask;
+            }
+        }
+#else
+        bool Probe(const TKey& key, const size_t hash, size_t& index, size_t& distance) const {
+            return ProbeScalar(key, hash, index, distance);
+        }
+#endif
+
+        size_t InsertPosition(const size_t hash, size_t& distance) const {
+            size_t index = hash & mask;
+            distance = 0;
+            while (Occupied(index) && Distance(index) >= distance) {
+                ++distance;
+                index = (index + 1) & mask;
+            }
+            return index;
+        }
 
-        Entry() = default;
+        size_t Find(const TKey& key, const size_t hash) const {
+            size_t index;
+            size_t distance;
+            return Probe(key, hash, index, distance) ? index : capacity;
+        }
 
-        Entry(const std::pair<TKey, TValue>& keyValue, const size_t distance, const bool occupied) :
-            keyValue(keyValue), distance(distance), occupied(occupied) {}
+        size_t Place(KeyValue keyValue, size_t hash, size_t distance, size_t index) {
+            const size_t target = index;
+
+            while (Occupied(index)) {
+                if (const size_t current = Distance(index); current < distance) {
+                    std::swap(keyValue, slots[index]);
+                    const size_t displacedHash = hashes[index];
+                    SetSlot(index, hash, distance);
+                    hash = displacedHash;
+                    distance = current;
+                }
+
+                ++distance;
+                index = (index + 1) & mask;
+            }
 
-        Entry(std::pair<TKey, TValue>&& keyValue, const size_t distance, const bool occupied) :
-            keyValue(std::move(keyValue)), distance(distance), occupied(occupied) {}
+            slots[index] = std::move(keyValue);
+            SetSlot(index, hash, distance);
+            return target;
+        }
+
+        void Erase(size_t index) {
+            size_t nextIndex = (index + 1) & mask;
+            while (Occupied(nextIndex) && Distance(nextIndex) > 0) {
+                const size_t distance = Distance(nextIndex);
+                slots[index] = std::move(slots[nextIndex]);
+                SetSlot(index, hashes[nextIndex], distance - 1);
+                index = nextIndex;
+                nextIndex = (nextIndex + 1) & mask;
+            }
+
+            SetMetadata(index, emptyControl, 0);
+            slots[index] = KeyValue();
+        }
     };
 
-    ArraySequence<Entry> table;
+    Table table;
+    // Table being drained into `table` while an incremental rehash is in progress; its slots below
+    // migrationCursor are already empty. Every key lives in exactly one of the two tables.
+    Table previous;
+    size_t migrationCursor;
     size_t size;
-    size_t capacity;
     float maxLoadFactor;
+    bool incrementalRehash;
 
-    size_t Hash(const TKey& key) const { return Hasher{}(key) % capacity; }
+    static constexpr size_t migrationStep = 8;
 
-    void Rehash() {
-        ArraySequence<Entry> oldTable = std::move(table);
-        capacity *= 2;
-        table = ArraySequence<Entry>(capacity);
-        size = 0;
-
-        for (auto& slot: oldTable) {
-            if (slot.occupied) {
-                Insert(slot.keyValue.first, slot.keyValue.second);
+    static size_t RoundUpToPowerOfTwo(const size_t value) {
+        size_t result = groupWidth;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    static size_t Hash(const TKey& key) { return Hasher{}(key); }
+
+    bool Migrating() const { return previous.capacity != 0; }
+
+    bool NeedsRehash() const { return static_cast<float>(size) / table.capacity > maxLoadFactor; }
+
+    void MoveSlot(Table& source, const size_t index) {
+        const size_t hash = source.hashes[index];
+        KeyValue keyValue = std::move(source.slots[index]);
+        source.Erase(index);
+
+        size_t distance;
+        const size_t position = table.InsertPosition(hash, distance);
+        table.Place(std::move(keyValue), hash, distance, position);
+    }
+
+    void MigrateSlots(size_t budget) {
+        while (budget > 0 && migrationCursor < previous.capacity) {
+            if (previous.Occupied(migrationCursor)) {
+                MoveSlot(previous, migrationCursor);
+            } else {
+                ++migrationCursor;
+            }
+            --budget;
+        }
+
+        if (migrationCursor == previous.capacity) {
+            previous = Table();
+            migrationCursor = 0;
+        }
+    }
+
+    void FinishMigration() {
+        if (Migrating()) {
+            MigrateSlots(static_cast<size_t>(-1));
+        }
+    }
+
+    void RehashTo(const size_t capacity) {
+        FinishMigration();
+        Table oldTable = std::move(table);
+        table = Table(capacity);
+
+        for (size_t index = 0; index < oldTable.capacity; ++index) {
+            if (oldTable.Occupied(index)) {
+                const size_t hash = oldTable.hashes[index];
+                table.Place(std::move(oldTable.slots[index]), hash, 0, hash & table.mask);
             }
         }
     }
 
+    void Rehash() {
+        if (!incrementalRehash) {
+            RehashTo(table.capacity * 2);
+            return;
+        }
+
+        FinishMigration();
+        previous = std::move(table);
+        table = Table(previous.capacity * 2);
+        migrationCursor = 0;
+    }
+
+    // Locates key in either table; returns the owning table or nullptr.
+    const Table* Locate(const TKey& key, size_t& index) const {
+        const size_t hash = Hash(key);
+        if ((index = table.Find(key, hash)) != table.capacity) {
+            return &table;
+        }
+        if (Migrating() && (index = previous.Find(key, hash)) != previous.capacity) {
+            return &previous;
+        }
+        return nullptr;
+    }
+
+    Table* Locate(const TKey& key, size_t& index) {
+        return const_cast<Table*>(static_cast<const IDictionary*>(this)->Locate(key, index));
+    }
+
 public:
-    explicit IDictionary(const size_t capacity = 16, const float maxLoadFactor = 0.9) :
-        table(ArraySequence<Entry>(capacity)), size(0), capacity(capacity), maxLoadFactor(maxLoadFactor) {}
+    // incrementalRehash moves migrationStep slots of the old table per insertion instead of all of them at once.
+    // The doubled table is still allocated and default-constructed in one step, so an insertion that triggers
+    // growth still pays for that, only not for moving the keys. Reserve avoids both.
+    explicit IDictionary(const size_t capacity = 16, const float maxLoadFactor = 0.9,
+                         const bool incrementalRehash = false) :
+        table(RoundUpToPowerOfTwo(capacity)), migrationCursor(0), size(0), maxLoadFactor(maxLoadFactor),
+        incrementalRehash(incrementalRehash) {}
 
     IDictionary(const IDictionary& other) :
-        table(other.table), size(other.size), capacity(other.capacity), maxLoadFactor(other.maxLoadFactor) {}
+        table(other.table), previous(other.previous), migrationCursor(other.migrationCursor), size(other.size),
+        maxLoadFactor(other.maxLoadFactor), incrementalRehash(other.incrementalRehash) {}
 
     IDictionary(IDictionary&& other) noexcept :
-        table(std::move(other.table)), size(other.size), capacity(other.capacity), maxLoadFactor(other.maxLoadFactor) {
+        table(std::move(other.table)), previous(std::move(other.previous)), migrationCursor(other.migrationCursor),
+        size(other.size), maxLoadFactor(other.maxLoadFactor), incrementalRehash(other.incrementalRehash) {
+        other.table = Table();
+        other.previous = Table();
+        other.migrationCursor = 0;
         other.size = 0;
-        other.capacity = 0;
+    }
+
+    // Grows the table once so that count entries fit without any further rehash.
+    void Reserve(const size_t count) {
+        const auto required = static_cast<size_t>(static_cast<double>(count) / maxLoadFactor) + 1;
+        if (required > table.capacity) {
+            RehashTo(RoundUpToPowerOfTwo(required));
+        }
     }
 
     void Insert(const TKey& key, const TValue& value) {
-        if (static_cast<float>(size) / capacity > maxLoadFactor) {
+        if (NeedsRehash()) {
             Rehash();
         }
+        if (Migrating()) {
+            MigrateSlots(migrationStep);
+        }
 
-        size_t index = Hash(key);
+        const size_t hash = Hash(key);
+        size_t index;
+        size_t distance;
+        if (table.Probe(key, hash, index, distance)) {
+            table.slots[index].second = value;
+            return;
+        }
+        if (size_t old; Migrating() && (old = previous.Find(key, hash)) != previous.capacity) {
+            previous.slots[old].second = value;
+            return;
+        }
 
-        Entry newEntry = {{key, value}, 0, true};
+        table.Place({key, value}, hash, distance, index);
+        ++size;
+    }
 
-        while (table[index].occupied) {
-            if (newEntry.keyValue.first == table[index].keyValue.first) {
-                table[index].keyValue.second = newEntry.keyValue.second;
-                return;
-            }
+    TValue& FindOrInsert(const TKey& key, const TValue& value = TValue()) {
+        return FindOrInsertWith(key, [&key]() -> const TKey& { return key; }, value);
+    }
 
-            if (table[index].distance < newEntry.distance) {
-                std::swap(newEntry, table[index]);
-            }
+    // Like FindOrInsert, but a missing key is stored as makeKey(), which must compare equal to key.
+    // Lets callers probe with a borrowed key and keep an owned copy only when it is actually inserted.
+    template<typename KeyFactory>
+    TValue& FindOrInsertWith(const TKey& key, KeyFactory&& makeKey, const TValue& value = TValue()) {
+        const size_t hash = Hash(key);
+        size_t index;
+        size_t distance;
+        if (table.Probe(key, hash, index, distance)) {
+            return table.slots[index].second;
+        }
+        if (size_t old; Migrating() && (old = previous.Find(key, hash)) != previous.capacity) {
+            return previous.slots[old].second;
+        }
 
-            ++newEntry.distance;
-            index = (index + 1) % capacity;
+        if (NeedsRehash()) {
+            Rehash();
+            index = table.InsertPosition(hash, distance);
+        }
+        if (Migrating()) {
+            MigrateSlots(migrationStep);
+            index = table.InsertPosition(hash, distance);
         }
 
-        table[index] = std::move(newEntry);
+        index = table.Place({makeKey(), value}, hash, distance, index);
         ++size;
+        return table.slots[index].second;
     }
 
-    TValue Get(const TKey& key) const {
-        size_t index = Hash(key);
-        size_t distance = 0;
-
-        while (table[index].occupied) {
-            if (table[index].keyValue.first == key) {
-                return table[index].keyValue.second;
-            }
-
-            if (distance > table[index].distance) {
-                throw std::runtime_error("Key not found");
-            }
+    template<typename Update>
+    TValue& Upsert(const TKey& key, Update&& update, const TValue& initial = TValue()) {
+        TValue& value = FindOrInsert(key, initial);
+        update(value);
+        return value;
+    }
 
-            ++distance;
-            index = (index + 1) % capacity;
+    TValue Get(const TKey& key) const {
+        size_t index;
+        const Table* owner = Locate(key, index);
+        if (owner == nullptr) {
+            throw std::runtime_error("Key not found");
         }
-        throw std::runtime_error("Key not found");
+        return owner->slots[index].second;
     }
 
     void Remove(const TKey& key) {
-        size_t index = Hash(key);
-        size_t distance = 0;
-
-        while (table[index].occupied) {
-            if (table[index].keyValue.first == key) {
-                table[index].occupied = false;
-                size_t nextIndex = (index + 1) % capacity;
-                while (table[nextIndex].occupied && table[nextIndex].distance > 0) {
-                    std::swap(table[index], table[nextIndex]);
-                    --table[index].distance;
-                    ++nextIndex;
-                }
-                --size;
-                return;
-            }
+        size_t index;
+        Table* owner = Locate(key, index);
+        if (owner == nullptr) {
+            throw std::runtime_error("Key not found");
+        }
 
-            if (distance > table[index].distance) {
-                throw std::runtime_error("Key not found");
-            }
+        owner->Erase(index);
+        --size;
+    }
 
-            ++distance;
-            index = (index + 1) % capacity;
-        }
+    // Returns the value of key, or nullptr if it is absent; one probe where Contains plus operator[] take two.
+    TValue* Find(const TKey& key) {
+        size_t index;
+        Table* owner = Locate(key, index);
+        return owner != nullptr ? &owner->slots[index].second : nullptr;
+    }
 
-        throw std::runtime_error("Key not found");
+    const TValue* Find(const TKey& key) const {
+        size_t index;
+        const Table* owner = Locate(key, index);
+        return owner != nullptr ? &owner->slots[index].second : nullptr;
     }
 
     bool Contains(const TKey& key) const {
-        size_t index = Hash(key);
-        size_t distance = 0;
+        size_t index;
+        return Locate(key, index) != nullptr;
+    }
 
-        while (table[index].occupied) {
-            if (table[index].keyValue.first == key) {
-                return true;
-            }
+    size_t GetCount() const { return size; }
 
-            if (distance > table[index].distance) {
-                return false;
-            }
+    size_t GetCapacity() const { return table.capacity; }
 
-            ++distance;
-            index = (index + 1) % capacity;
-        }
-        return false;
-    }
+    bool IsRehashing() const { return Migrating(); }
 
-    size_t GetCount() const { return size; }
+    double GetAverageProbeLength() const {
+        if (size == 0) {
+            return 0.0;
+        }
 
-    size_t GetCapacity() const { return capacity; }
+        size_t total = 0;
+        for (const Table* current: {&previous, &table}) {
+            for (size_t index = 0; index < current->capacity; ++index) {
+                if (current->Occupied(index)) {
+                    total += current->Distance(index) + 1;
+                }
+            }
+        }
+        return static_cast<double>(total) / static_cast<double>(size);
+    }
 
     class Iterator {
-        using InnerIterator = typename ArraySequence<Entry>::Iterator;
-        InnerIterator current;
-        InnerIterator end;
+        Table* previous;
+        Table* table;
+        Table* current;
+        size_t index;
 
         void skipEmpty() {
-            while (current != end && !current->occupied) {
-                ++current;
+            while (true) {
+                while (index < current->capacity && !current->Occupied(index)) {
+                    ++index;
+                }
+                if (index < current->capacity || current == table) {
+                    return;
+                }
+                current = table;
+                index = 0;
             }
         }
 
@@ -168,17 +476,17 @@ public:
         using pointer = value_type*;
         using reference = value_type&;
 
-        Iterator(InnerIterator start, InnerIterator end) :
-            current(start), end(end) {
+        Iterator(Table* previous, Table* table, Table* current, const size_t index) :
+            previous(previous), table(table), current(current), index(index) {
             skipEmpty();
         }
 
-        reference operator*() const { return current->keyValue; }
+        reference operator*() const { return current->slots[index]; }
 
-        pointer operator->() const { return &current->keyValue; }
+        pointer operator->() const { return &current->slots[index]; }
 
         Iterator& operator++() {
-            ++current;
+            ++index;
             skipEmpty();
             return *this;
         }
@@ -189,22 +497,24 @@ public:
             return tmp;
         }
 
-        bool operator==(const Iterator& other) const { return current == other.current; }
+        bool operator==(const Iterator& other) const { return current == other.current && index == other.index; }
 
-        bool operator!=(const Iterator& other) const { return current != other.current; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
     };
 
 
-    Iterator begin() { return Iterator(table.begin(), table.end()); }
+    Iterator begin() { return Iterator(&previous, &table, &previous, 0); }
 
-    Iterator end() { return Iterator(table.end(), table.end()); }
+    Iterator end() { return Iterator(&previous, &table, &table, table.capacity); }
 
     IDictionary& operator=(const IDictionary& other) {
         if (this != &other) {
             size = other.size;
-            capacity = other.capacity;
             maxLoadFactor = other.maxLoadFactor;
+            incrementalRehash = other.incrementalRehash;
+            migrationCursor = other.migrationCursor;
             table = other.table;
+            previous = other.previous;
         }
         return *this;
     }
@@ -212,42 +522,51 @@ public:
     IDictionary& operator=(IDictionary&& other) noexcept {
         if (this != &other) {
             size = other.size;
-            capacity = other.capacity;
             maxLoadFactor = other.maxLoadFactor;
+            incrementalRehash = other.incrementalRehash;
+            migrationCursor = other.migrationCursor;
             table = std::move(other.table);
+            previous = std::move(other.previous);
+            other.table = Table();
+            other.previous = Table();
+            other.migrationCursor = 0;
             other.size = 0;
-            other.capacity = 0;
         }
         return *this;
     }
 
+    // Compares contents, not layout: equal when both hold the same key/value pairs, whatever their capacity,
+    // load factor, slot order or rehash progress. Values need operator==.
     bool operator==(const IDictionary& other) const {
-        return size == other.size && capacity == other.capacity && maxLoadFactor == other.maxLoadFactor &&
-               table == other.table;
-    }
-
-    bool operator!=(const IDictionary& other) const {
-        return size != other.size || capacity != other.capacity || maxLoadFactor != other.maxLoadFactor ||
-               table != other.table;
-    }
-
-    TValue& operator[](const TKey& key) {
-        size_t index = Hash(key);
-        size_t distance = 0;
+        if (size != other.size) {
+            return false;
+        }
 
-        while (table[index].occupied) {
-            if (table[index].keyValue.first == key) {
-                return table[index].keyValue.second;
+        for (const Table* current: {&previous, &table}) {
+            for (size_t index = 0; index < current->capacity; ++index) {
+                if (!current->Occupied(index)) {
+                    continue;
+                }
+                const KeyValue& keyValue = current->slots[index];
+                size_t found;
+                const Table* owner = other.Locate(keyValue.first, found);
+                if (owner == nullptr || !(owner->slots[found].second == keyValue.second)) {
+                    return false;
+                }
             }
+        }
+        return true;
+    }
 
-            if (distance > table[index].distance) {
-                throw std::runtime_error("Key not found");
-            }
+    bool operator!=(const IDictionary& other) const { return !(*this == other); }
 
-            ++distance;
-            index = (index + 1) % capacity;
+    TValue& operator[](const TKey& key) {
+        size_t index;
+        Table* owner = Locate(key, index);
+        if (owner == nullptr) {
+            throw std::runtime_error("Key not found");
         }
-        throw std::runtime_error("Key not found");
+        return owner->slots[index].second;
     }
 
     ~IDictionary() = default;
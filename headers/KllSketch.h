@@ -0,0 +1,181 @@
+#ifndef KLLSKETCH_H
+#define KLLSKETCH_H
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "../../sequences/arraySequence.h"
+#include "../../sorting/quickSort.h"
+
+// KLL quantile sketch. Level h holds items that each stand for 2^h inputs. When the sketch outgrows its
+// capacity, the lowest full level is sorted and every other item, starting at a random offset, is promoted to
+// the next level. Level capacities shrink by 2/3 going down from the top level, and the top level holds k items,
+// so memory is O(k) words however many values arrive. Sketches built with the same k merge level by level. The
+// rank of a reported quantile is off by at most GetRankError() * GetCount() with roughly 99% confidence.
+template<typename T>
+class KllSketch final {
+    static constexpr size_t minLevelCapacity = 8;
+
+    size_t k;
+    size_t count = 0;
+    size_t retained = 0;
+    size_t capacity = 0;
+    ArraySequence<ArraySequence<T>> levels;
+    T min{};
+    T max{};
+    uint64_t coin = 0x9E3779B97F4A7C15ULL;
+
+    size_t LevelCapacity(const size_t level) const {
+        const double depth = static_cast<double>(levels.GetLength() - 1 - level);
+        const auto scaled = static_cast<size_t>(std::ceil(static_cast<double>(k) * std::pow(2.0 / 3.0, depth)));
+        return std::max(minLevelCapacity, scaled);
+    }
+
+    void UpdateCapacity() {
+        capacity = 0;
+        for (size_t level = 0; level < levels.GetLength(); ++level) {
+            capacity += LevelCapacity(level);
+        }
+    }
+
+    bool FlipCoin() {
+        coin ^= coin << 13;
+        coin ^= coin >> 7;
+        coin ^= coin << 17;
+        return coin & 1;
+    }
+
+    void CompactLevel(const size_t level) {
+        if (level + 1 == levels.GetLength()) {
+            levels.Append(ArraySequence<T>());
+            UpdateCapacity();
+        }
+        ArraySequence<T>& items = levels[level];
+        QuickSorter<T> sorter;
+        sorter.Sort(items, [](const T& left, const T& right) { return left < right; });
+
+        // An odd item out stays behind, so only an even number of items is halved.
+        const size_t length = items.GetLength();
+        const size_t paired = length - length % 2;
+        for (size_t index = FlipCoin() ? 1 : 0; index < paired; index += 2) {
+            levels[level + 1].Append(items[index]);
+        }
+        ArraySequence<T> rest;
+        if (paired < length) {
+            rest.Append(items[length - 1]);
+        }
+        retained -= length - rest.GetLength() - paired / 2;
+        levels[level] = std::move(rest);
+    }
+
+    void Compress() {
+        while (retained > capacity) {
+            size_t level = 0;
+            while (levels[level].GetLength() < LevelCapacity(level)) {
+                ++level;
+            }
+            CompactLevel(level);
+        }
+    }
+
+public:
+    // k 0 makes an unused sketch that accepts no values.
+    explicit KllSketch(const size_t k = 0) : k(k) {
+        if (k > 0) {
+            levels.Append(ArraySequence<T>());
+            UpdateCapacity();
+        }
+    }
+
+    // Smallest k whose empirical single-quantile rank error is at most epsilon.
+    static size_t KForRankError(const double epsilon) {
+        if (!(epsilon > 0 && epsilon < 1)) {
+            throw std::invalid_argument("Quantile rank error must lie in (0, 1)");
+        }
+        return std::max(minLevelCapacity, static_cast<size_t>(std::ceil(std::pow(2.296 / epsilon, 1 / 0.9723))));
+    }
+
+    void Add(const T& value) {
+        if (k == 0) {
+            throw std::logic_error("Sketch was created without capacity");
+        }
+        min = count == 0 ? value : std::min(min, value);
+        max = count == 0 ? value : std::max(max, value);
+        ++count;
+        levels[0].Append(value);
+        if (++retained > capacity) {
+            Compress();
+        }
+    }
+
+    void Merge(const KllSketch& other) {
+        if (other.count == 0) {
+            return;
+        }
+        if (k != other.k) {
+            throw std::invalid_argument("Merged sketches must share k");
+        }
+        min = count == 0 ? other.min : std::min(min, other.min);
+        max = count == 0 ? other.max : std::max(max, other.max);
+        count += other.count;
+        while (levels.GetLength() < other.levels.GetLength()) {
+            levels.Append(ArraySequence<T>());
+        }
+        for (size_t level = 0; level < other.levels.GetLength(); ++level) {
+            for (const T& item: other.levels[level]) {
+                levels[level].Append(item);
+            }
+        }
+        retained += other.retained;
+        UpdateCapacity();
+        Compress();
+    }
+
+    // Smallest retained value whose weighted rank reaches q * GetCount(); q 0 and 1 give the exact min and max.
+    // NaN for an empty sketch.
+    double GetQuantile(const double q) const {
+        if (count == 0) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        if (q <= 0) {
+            return static_cast<double>(min);
+        }
+        if (q >= 1) {
+            return static_cast<double>(max);
+        }
+
+        ArraySequence<std::pair<T, size_t>> weighted;
+        for (size_t level = 0; level < levels.GetLength(); ++level) {
+            for (const T& item: levels[level]) {
+                weighted.Append({item, size_t{1} << level});
+            }
+        }
+        QuickSorter<std::pair<T, size_t>> sorter;
+        sorter.Sort(weighted, [](const std::pair<T, size_t>& left, const std::pair<T, size_t>& right) {
+            return left.first < right.first;
+        });
+
+        const double target = q * static_cast<double>(count);
+        size_t rank = 0;
+        for (const auto& [item, weight]: weighted) {
+            rank += weight;
+            if (static_cast<double>(rank) >= target) {
+                return static_cast<double>(item);
+            }
+        }
+        return static_cast<double>(max);
+    }
+
+    size_t GetK() const { return k; }
+
+    size_t GetCount() const { return count; }
+
+    size_t GetRetained() const { return retained; }
+
+    double GetRankError() const { return k == 0 ? 1.0 : 2.296 / std::pow(static_cast<double>(k), 0.9723); }
+};
+
+#endif // KLLSKETCH_H
@@ -0,0 +1,38 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+#include <string>
+#include <string_view>
+
+enum class AccessPattern { Sequential, Random };
+
+// Read-only view of a whole input file. Regular files are memory-mapped, so the counting engines work on the
+// page cache directly and the kernel pages the text in and out as needed; pipes, character devices and
+// platforms without mmap fall back to reading the stream into an owned buffer in large blocks.
+// "-" names standard input.
+class MappedFile final {
+    const char* data = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+    std::string buffer;
+
+    void Release();
+
+public:
+    explicit MappedFile(const std::string& path, AccessPattern pattern = AccessPattern::Sequential);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    ~MappedFile();
+
+    std::string_view GetView() const { return {data, size}; }
+
+    size_t GetSize() const { return size; }
+
+    bool IsMapped() const { return mapped; }
+};
+
+#endif // MAPPEDFILE_H
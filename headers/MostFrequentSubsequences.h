@@ -2,12 +2,74 @@
 #define MOSTFREQUENTSUBSEQUENCES_H
 #include <stdexcept>
 #include <fstream>
+#include "CodePointIndex.h"
 #include "FNV1aHash.h"
 #include "IDictionary.h"
+#include "ResultWriter.h"
+#include "RollingHash.h"
+#include "StringArena.h"
 
-IDictionary<std::string, size_t, FNV1a<std::string>> createPrefixTable(const std::string& str, size_t lmin,
+enum class CountingEngine { HashTable, RollingHash, SuffixArray };
+
+// Byte measures lmin/lmax and slices in bytes; CodePoint measures them in UTF-8 code points, so Cyrillic letters
+// are never split. Word counts n-grams of lmin..lmax tokens (see WordNGrams.h) and ignores the counting engine.
+enum class TextUnit { Byte, CodePoint, Word };
+
+// Table keeps whatever order the engine produces (hash order, or key order for the suffix array) and is the
+// cheapest; the others sort the entries before writing.
+enum class OutputOrder { Table, CountDescending, KeyAscending };
+
+struct SubsequenceSearchOptions {
+    CountingEngine engine = CountingEngine::HashTable;
+    size_t topK = 0;
+    size_t threadCount = 1;
+    // Bytes for the counting table and its keys; 0 keeps everything in memory. A non-zero budget streams the
+    // input and spills sorted runs to disk, writing the results in lexicographic order. Top-K stays in memory.
+    size_t memoryBudget = 0;
+    OutputOrder order = OutputOrder::Table;
+    OutputFormat format = OutputFormat::Text;
+    // Code point and word counting need the whole text in memory and are not available with a memory budget.
+    TextUnit unit = TextUnit::Byte;
+    // A positive epsilon streams the input through a Count-Min sketch (see ApproximateSubstringCounter.h) and
+    // reports estimated top-K counts in fixed memory, with the error bounds in approximation.txt. Needs topK > 0.
+    double approximateError = 0;
+    double approximateFailure = 0.01;
+};
+
+IDictionary<std::string, size_t, FNV1a<std::string>> createPrefixTable(std::string_view str, size_t lmin, size_t lmax);
+
+IDictionary<std::string, size_t, FNV1a<std::string>> createPrefixTable(const CodePointIndex& text, size_t lmin,
                                                                        size_t lmax);
 
-void processFileAndSaveResults(const std::string& inputFile, const std::string& outputFile, size_t lmin, size_t lmax);
+IDictionary<std::string_view, size_t, FNV1a<std::string_view>> createPrefixTableArena(std::string_view str, size_t lmin,
+                                                                                     size_t lmax, StringArena& arena);
+
+IDictionary<std::string_view, size_t, FNV1a<std::string_view>>
+createPrefixTableArena(const CodePointIndex& text, size_t lmin, size_t lmax, StringArena& arena);
+
+IDictionary<std::string, size_t, FNV1a<std::string>> createPrefixTableParallel(std::string_view str, size_t lmin,
+                                                                               size_t lmax, size_t threadCount);
+
+IDictionary<std::string, size_t, FNV1a<std::string>> createPrefixTableParallel(const CodePointIndex& text, size_t lmin,
+                                                                               size_t lmax, size_t threadCount);
+
+IDictionary<SubstringView, size_t, SubstringViewHash> createPrefixTableRolling(std::string_view str, size_t lmin,
+                                                                               size_t lmax);
+
+IDictionary<SubstringView, size_t, SubstringViewHash> createPrefixTableRolling(const CodePointIndex& text, size_t lmin,
+                                                                               size_t lmax);
+
+IDictionary<std::string, size_t, FNV1a<std::string>> createPrefixTableSuffixArray(std::string_view str, size_t lmin,
+                                                                                  size_t lmax);
+
+IDictionary<std::string, size_t, FNV1a<std::string>> createPrefixTableSuffixArray(const CodePointIndex& text,
+                                                                                  size_t lmin, size_t lmax);
+
+ArraySequence<ArraySequence<std::pair<std::string, size_t>>>
+findMostFrequentSubsequences(std::string_view str, size_t lmin, size_t lmax, size_t k,
+                             CountingEngine engine = CountingEngine::SuffixArray, TextUnit unit = TextUnit::Byte);
+
+void processFileAndSaveResults(const std::string& inputFile, const std::string& outputFile, size_t lmin, size_t lmax,
+                               const SubsequenceSearchOptions& options = {});
 
 #endif // MOSTFREQUENTSUBSEQUENCES_H
@@ -1,8 +1,12 @@
 #ifndef MURMURHASH_H
 #define MURMURHASH_H
+#include <algorithm>
+#include <bit>
 #include <cstdint>
 #include <cstring>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include "Concepts.h"
 
 template<typename T>
@@ -12,7 +16,7 @@ struct MurmurHash {
 
 template<Integer T>
 struct MurmurHash<T> {
-    size_t operator()(const T& key) const {
+    constexpr size_t operator()(const T& key) const {
         size_t hash = 0xc70f6907UL;
         auto k = static_cast<size_t>(key);
         k *= 0xcc9e2d51UL;
@@ -55,35 +59,100 @@ struct MurmurHash<T> {
 
 template<Pointer T>
 struct MurmurHash<T> {
-    size_t operator()(const T& key) { return MurmurHash<std::uintptr_t>{}(reinterpret_cast<std::uintptr_t>(key)); }
+    size_t operator()(const T& key) const {
+        return MurmurHash<std::uintptr_t>{}(reinterpret_cast<std::uintptr_t>(key));
+    }
 };
 
-template<String T>
-struct MurmurHash<T> {
-    size_t operator()(const T& key) const {
-        size_t hash = 0xc70f6907UL;
-        const char* data = key.c_str();
-        const size_t length = std::strlen(data);
+constexpr uint64_t murmurMix64(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
 
-        for (std::size_t i = 0; i < length; ++i) {
-            constexpr std::size_t c1 = 0xcc9e2d51UL;
-            constexpr std::size_t c2 = 0x1b873593UL;
-            auto k = static_cast<size_t>(static_cast<unsigned char>(data[i]));
-            k *= c1;
-            k = k << 15 | k >> 32 - 15;
-            k *= c2;
-            hash ^= k;
-            hash = hash << 13 | hash >> 32 - 13;
-            hash = hash * 5 + 0xe6546b64UL;
+constexpr uint64_t murmurLoad64(const char* data) {
+    if (std::is_constant_evaluated()) {
+        uint64_t word = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            word |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << i * 8;
         }
+        return word;
+    }
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return word;
+}
 
-        hash ^= length;
-        hash ^= hash >> 16;
-        hash *= 0x85ebca6bUL;
-        hash ^= hash >> 13;
-        hash *= 0xc2b2ae35UL;
-        hash ^= hash >> 16;
-        return hash;
+// MurmurHash3_x64_128 over an explicit length, 16 bytes per round; returns the low 64 bits.
+constexpr uint64_t murmurHash3x64(const char* data, const size_t length, const uint64_t seed) {
+    constexpr uint64_t c1 = 0x87c37b91114253d5ULL;
+    constexpr uint64_t c2 = 0x4cf5ad432745937fULL;
+    uint64_t h1 = seed;
+    uint64_t h2 = seed;
+    const size_t blocks = length / 16;
+
+    for (size_t i = 0; i < blocks; ++i) {
+        uint64_t k1 = murmurLoad64(data + i * 16);
+        uint64_t k2 = murmurLoad64(data + i * 16 + 8);
+
+        k1 *= c1;
+        k1 = std::rotl(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+        h1 = std::rotl(h1, 27);
+        h1 += h2;
+        h1 = h1 * 5 + 0x52dce729;
+
+        k2 *= c2;
+        k2 = std::rotl(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+        h2 = std::rotl(h2, 31);
+        h2 += h1;
+        h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    const char* tail = data + blocks * 16;
+    const size_t rest = length & 15;
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+    for (size_t i = rest; i > 8; --i) {
+        k2 ^= static_cast<uint64_t>(static_cast<unsigned char>(tail[i - 1])) << (i - 9) * 8;
+    }
+    for (size_t i = std::min<size_t>(rest, 8); i > 0; --i) {
+        k1 ^= static_cast<uint64_t>(static_cast<unsigned char>(tail[i - 1])) << (i - 1) * 8;
+    }
+    if (rest > 8) {
+        k2 *= c2;
+        k2 = std::rotl(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+    }
+    if (rest > 0) {
+        k1 *= c1;
+        k1 = std::rotl(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+    }
+
+    h1 ^= length;
+    h2 ^= length;
+    h1 += h2;
+    h2 += h1;
+    h1 = murmurMix64(h1);
+    h2 = murmurMix64(h2);
+    h1 += h2;
+    return h1;
+}
+
+template<String T>
+struct MurmurHash<T> {
+    constexpr size_t operator()(const T& key) const {
+        const std::string_view view(key);
+        return murmurHash3x64(view.data(), view.size(), 0xc70f6907UL);
     }
 };
 
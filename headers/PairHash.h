@@ -0,0 +1,17 @@
+#ifndef PAIRHASH_H
+#define PAIRHASH_H
+#include <functional>
+#include <utility>
+
+
+template<typename T1, typename T2>
+struct std::hash<std::pair<T1, T2>> {
+    std::size_t operator()(const std::pair<T1, T2>& p) const {
+        std::size_t h1 = std::hash<T1>{}(p.first);
+        std::size_t h2 = std::hash<T2>{}(p.second);
+
+        return h1 ^ (h2 << 1);
+    }
+};
+
+#endif // PAIRHASH_H
@@ -0,0 +1,47 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+#include <exception>
+#include <thread>
+
+#include "../../sequences/arraySequence.h"
+
+inline size_t resolveThreadCount(const size_t requested) {
+    if (requested != 0) {
+        return requested;
+    }
+    const size_t hardware = std::thread::hardware_concurrency();
+    return hardware == 0 ? 1 : hardware;
+}
+
+// Runs task(0) .. task(taskCount - 1) on separate threads and rethrows the first failure after all of them finish.
+template<typename Task>
+void parallelFor(const size_t taskCount, Task&& task) {
+    if (taskCount == 1) {
+        task(size_t{0});
+        return;
+    }
+
+    ArraySequence<std::exception_ptr> errors(taskCount);
+    ArraySequence<std::thread> workers(taskCount);
+    for (size_t index = 0; index < taskCount; ++index) {
+        workers[index] = std::thread([&task, &errors, index] {
+            try {
+                task(index);
+            } catch (...) {
+                errors[index] = std::current_exception();
+            }
+        });
+    }
+
+    for (size_t index = 0; index < taskCount; ++index) {
+        workers[index].join();
+    }
+
+    for (size_t index = 0; index < taskCount; ++index) {
+        if (errors[index]) {
+            std::rethrow_exception(errors[index]);
+        }
+    }
+}
+
+#endif // PARALLEL_H
@@ -0,0 +1,104 @@
+#ifndef RANGEINDEX_H
+#define RANGEINDEX_H
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "../../sequences/arraySequence.h"
+#include "../../sorting/quickSort.h"
+
+// Half-open ranges [first, second) compiled once for point lookups. The range ends become a sorted boundary
+// array; boundary slot j covers [boundaries[j], boundaries[j + 1]) and maps to the range covering it, or to npos
+// for a gap between ranges. Lookups are a branchless binary search over the boundaries, or a single table read
+// when the ranges span at most denseSpanLimit values. Empty and overlapping ranges are rejected on construction.
+class RangeIndex final {
+    using Range = std::pair<int, int>;
+
+    ArraySequence<int> boundaries;
+    ArraySequence<size_t> slotRanges;
+    ArraySequence<uint32_t> dense;
+    bool gaps = false;
+
+public:
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+    static constexpr int64_t denseSpanLimit = int64_t{1} << 16;
+
+    RangeIndex() = default;
+
+    explicit RangeIndex(const ArraySequence<Range>& ranges) {
+        const size_t count = ranges.GetLength();
+        if (count == 0) {
+            return;
+        }
+
+        ArraySequence<size_t> order(count);
+        for (size_t index = 0; index < count; ++index) {
+            if (ranges[index].first >= ranges[index].second) {
+                throw std::invalid_argument("Empty range");
+            }
+            order[index] = index;
+        }
+        QuickSorter<size_t> sorter;
+        sorter.Sort(order, [&ranges](const size_t& left, const size_t& right) {
+            return ranges[left].first < ranges[right].first;
+        });
+
+        boundaries.Append(ranges[order[0]].first);
+        for (size_t position = 0; position < count; ++position) {
+            const Range& range = ranges[order[position]];
+            if (range.first < boundaries[boundaries.GetLength() - 1]) {
+                throw std::invalid_argument("Overlapping ranges");
+            }
+            if (range.first > boundaries[boundaries.GetLength() - 1]) {
+                slotRanges.Append(npos);
+                boundaries.Append(range.first);
+                gaps = true;
+            }
+            slotRanges.Append(order[position]);
+            boundaries.Append(range.second);
+        }
+
+        const int low = boundaries[0];
+        const int64_t span = static_cast<int64_t>(boundaries[boundaries.GetLength() - 1]) - low;
+        if (span <= denseSpanLimit && count < std::numeric_limits<uint32_t>::max()) {
+            dense = ArraySequence<uint32_t>(static_cast<size_t>(span));
+            for (size_t slot = 0; slot < slotRanges.GetLength(); ++slot) {
+                const auto value = slotRanges[slot] == npos ? std::numeric_limits<uint32_t>::max()
+                                                            : static_cast<uint32_t>(slotRanges[slot]);
+                for (int point = boundaries[slot]; point < boundaries[slot + 1]; ++point) {
+                    dense[static_cast<size_t>(point - low)] = value;
+                }
+            }
+        }
+    }
+
+    // Index in the original range sequence of the range containing value, or npos.
+    size_t Find(const int value) const {
+        const size_t count = boundaries.GetLength();
+        if (count == 0 || value < boundaries[0] || value >= boundaries[count - 1]) {
+            return npos;
+        }
+
+        if (dense.GetLength() > 0) {
+            const uint32_t range = dense[static_cast<size_t>(static_cast<int64_t>(value) - boundaries[0])];
+            return range == std::numeric_limits<uint32_t>::max() ? npos : range;
+        }
+
+        // Invariant: boundaries[base] <= value < boundaries[base + length].
+        size_t base = 0;
+        size_t length = count - 1;
+        while (length > 1) {
+            const size_t half = length / 2;
+            base = boundaries[base + half] <= value ? base + half : base;
+            length -= half;
+        }
+        return slotRanges[base];
+    }
+
+    bool HasGaps() const { return gaps; }
+
+    bool IsDense() const { return dense.GetLength() > 0; }
+};
+
+#endif // RANGEINDEX_H
@@ -0,0 +1,47 @@
+#ifndef RESULTWRITER_H
+#define RESULTWRITER_H
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "../../sequences/arraySequence.h"
+
+enum class OutputFormat { Text, Binary };
+
+// Writes "key - count" lines, or binary records, through one large buffer instead of flushing per line.
+// The binary format is the magic "SSC1" followed by records of varint key length, key bytes and varint count,
+// with varints in LEB128 (seven bits per byte, low bits first).
+class ResultWriter final {
+    std::ofstream stream;
+    std::string buffer;
+    OutputFormat format;
+
+    void Flush();
+
+public:
+    using Entry = std::pair<std::string_view, size_t>;
+
+    static constexpr size_t bufferSize = size_t{1} << 20;
+
+    ResultWriter(const std::filesystem::path& path, OutputFormat format);
+
+    ResultWriter(const ResultWriter&) = delete;
+    ResultWriter& operator=(const ResultWriter&) = delete;
+
+    ~ResultWriter();
+
+    static const char* FileName(OutputFormat format);
+
+    static void Format(std::string& target, OutputFormat format, std::string_view key, size_t count);
+
+    void Write(std::string_view key, size_t count);
+
+    // Formats blocks of entries on up to threadCount threads and writes them in order.
+    void WriteAll(const ArraySequence<Entry>& entries, size_t threadCount);
+
+    void Close();
+};
+
+#endif // RESULTWRITER_H
@@ -0,0 +1,40 @@
+#ifndef ROLLINGHASH_H
+#define ROLLINGHASH_H
+#include <cstdint>
+#include <string_view>
+
+// Polynomial hash modulo the Mersenne prime 2^61 - 1, extended one character at a time.
+struct RollingHash {
+    static constexpr uint64_t modulus = (uint64_t{1} << 61) - 1;
+    static constexpr uint64_t base = 0x1f3d5b79a2c4e687ULL % modulus;
+
+    static uint64_t Extend(const uint64_t hash, const unsigned char symbol) {
+        const unsigned __int128 product = static_cast<unsigned __int128>(hash) * base + symbol + 1;
+        uint64_t result = static_cast<uint64_t>(product & modulus) + static_cast<uint64_t>(product >> 61);
+        if (result >= modulus) {
+            result -= modulus;
+        }
+        return result;
+    }
+};
+
+struct SubstringView {
+    std::string_view text;
+    size_t hash = 0;
+
+    bool operator==(const SubstringView& other) const { return hash == other.hash && text == other.text; }
+
+    bool operator!=(const SubstringView& other) const { return !(*this == other); }
+};
+
+struct SubstringViewHash {
+    size_t operator()(const SubstringView& key) const {
+        size_t hash = key.hash;
+        hash ^= hash >> 31;
+        hash *= 0x9e3779b97f4a7c15ULL;
+        hash ^= hash >> 29;
+        return hash;
+    }
+};
+
+#endif // ROLLINGHASH_H
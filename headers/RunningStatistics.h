@@ -0,0 +1,88 @@
+#ifndef RUNNINGSTATISTICS_H
+#define RUNNINGSTATISTICS_H
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+// Count, mean, central moments M2..M4, min and max of a value stream in one pass. Add is Welford's update
+// extended to the third and fourth moments; Merge combines two accumulators with Chan's pairwise formulas, so
+// chunks counted on separate threads merge into the same result as one serial pass, up to rounding. Variance,
+// skewness and kurtosis are population statistics; kurtosis is the excess over the normal distribution.
+// Every statistic of an empty accumulator is NaN, as are skewness and kurtosis of a constant stream.
+class RunningStatistics final {
+    size_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    double m3 = 0.0;
+    double m4 = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    static constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+
+public:
+    void Add(const double value) {
+        const double n1 = static_cast<double>(count++);
+        const double n = n1 + 1;
+        const double delta = value - mean;
+        const double deltaN = delta / n;
+        const double deltaN2 = deltaN * deltaN;
+        const double term = delta * deltaN * n1;
+
+        mean += deltaN;
+        m4 += term * deltaN2 * (n * n - 3 * n + 3) + 6 * deltaN2 * m2 - 4 * deltaN * m3;
+        m3 += term * deltaN * (n - 2) - 3 * deltaN * m2;
+        m2 += term;
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    void Merge(const RunningStatistics& other) {
+        if (other.count == 0) {
+            return;
+        }
+        if (count == 0) {
+            *this = other;
+            return;
+        }
+
+        const double na = static_cast<double>(count);
+        const double nb = static_cast<double>(other.count);
+        const double n = na + nb;
+        const double delta = other.mean - mean;
+        const double delta2 = delta * delta;
+
+        const double mergedM2 = m2 + other.m2 + delta2 * na * nb / n;
+        const double mergedM3 = m3 + other.m3 + delta2 * delta * na * nb * (na - nb) / (n * n) +
+                                3 * delta * (na * other.m2 - nb * m2) / n;
+        m4 += other.m4 + delta2 * delta2 * na * nb * (na * na - na * nb + nb * nb) / (n * n * n) +
+              6 * delta2 * (na * na * other.m2 + nb * nb * m2) / (n * n) + 4 * delta * (na * other.m3 - nb * m3) / n;
+        m3 = mergedM3;
+        m2 = mergedM2;
+        mean += delta * nb / n;
+        count += other.count;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    size_t GetCount() const { return count; }
+
+    double GetMean() const { return count == 0 ? nan : mean; }
+
+    double GetVariance() const { return count == 0 ? nan : m2 / static_cast<double>(count); }
+
+    double GetStandardDeviation() const { return std::sqrt(GetVariance()); }
+
+    double GetSkewness() const {
+        return m2 == 0 ? nan : std::sqrt(static_cast<double>(count)) * m3 / std::pow(m2, 1.5);
+    }
+
+    double GetKurtosis() const { return m2 == 0 ? nan : static_cast<double>(count) * m4 / (m2 * m2) - 3.0; }
+
+    double GetMin() const { return count == 0 ? nan : min; }
+
+    double GetMax() const { return count == 0 ? nan : max; }
+};
+
+#endif // RUNNINGSTATISTICS_H
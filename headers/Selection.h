@@ -0,0 +1,91 @@
+#ifndef SELECTION_H
+#define SELECTION_H
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include "../../sequences/arraySequence.h"
+
+// Order statistics of an unsorted int column in linear time, without reordering or copying it. Columns whose
+// values span at most selectionCountingSpanLimit use one counting pass over [min, max]; wider columns use a
+// three-pass radix select over 11-bit digits of the order-preserving unsigned image of each value.
+inline constexpr int64_t selectionCountingSpanLimit = int64_t{1} << 16;
+inline constexpr unsigned selectionRadixBits = 11;
+inline constexpr size_t selectionRadixBuckets = size_t{1} << selectionRadixBits;
+
+inline uint32_t orderedBits(const int value) { return static_cast<uint32_t>(value) ^ 0x80000000U; }
+
+inline int fromOrderedBits(const uint32_t bits) { return static_cast<int>(bits ^ 0x80000000U); }
+
+// k-th smallest value (0-based) using the counting pass; span is max - min + 1.
+inline int countingSelect(const ArraySequence<int>& values, const size_t k, const int min, const size_t span) {
+    ArraySequence<size_t> counts(span);
+    for (const int value: values) {
+        ++counts[static_cast<size_t>(static_cast<int64_t>(value) - min)];
+    }
+    size_t seen = 0;
+    for (size_t offset = 0; offset < span; ++offset) {
+        seen += counts[offset];
+        if (seen > k) {
+            return static_cast<int>(min + static_cast<int64_t>(offset));
+        }
+    }
+    return static_cast<int>(min + static_cast<int64_t>(span) - 1);
+}
+
+// k-th smallest value (0-based) fixing the digits from the most significant down; each pass counts only
+// the values that match the prefix fixed so far.
+inline int radixSelect(const ArraySequence<int>& values, size_t k) {
+    uint32_t prefix = 0;
+    uint32_t prefixMask = 0;
+    ArraySequence<size_t> counts(selectionRadixBuckets);
+    for (int shift = 32 - static_cast<int>(selectionRadixBits); shift > -static_cast<int>(selectionRadixBits);
+         shift -= static_cast<int>(selectionRadixBits)) {
+        const unsigned low = static_cast<unsigned>(std::max(shift, 0));
+        const unsigned width = shift >= 0 ? selectionRadixBits : selectionRadixBits + shift;
+        const uint32_t digitMask = (uint32_t{1} << width) - 1;
+
+        for (size_t bucket = 0; bucket < selectionRadixBuckets; ++bucket) {
+            counts[bucket] = 0;
+        }
+        for (const int value: values) {
+            const uint32_t bits = orderedBits(value);
+            if ((bits & prefixMask) == prefix) {
+                ++counts[bits >> low & digitMask];
+            }
+        }
+
+        size_t digit = 0;
+        while (counts[digit] <= k) {
+            k -= counts[digit++];
+        }
+        prefix |= static_cast<uint32_t>(digit) << low;
+        prefixMask |= digitMask << low;
+    }
+    return fromOrderedBits(prefix);
+}
+
+inline int selectNth(const ArraySequence<int>& values, const size_t k) {
+    int min = std::numeric_limits<int>::max();
+    int max = std::numeric_limits<int>::min();
+    for (const int value: values) {
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+    const int64_t span = static_cast<int64_t>(max) - min + 1;
+    if (span <= selectionCountingSpanLimit) {
+        return countingSelect(values, k, min, static_cast<size_t>(span));
+    }
+    return radixSelect(values, k);
+}
+
+// Median of a non-empty column: the middle value, or the mean of the two middle values.
+inline double medianOf(const ArraySequence<int>& values) {
+    const size_t n = values.GetLength();
+    if (n % 2 == 1) {
+        return selectNth(values, n / 2);
+    }
+    return (static_cast<double>(selectNth(values, n / 2 - 1)) + selectNth(values, n / 2)) / 2.0;
+}
+
+#endif // SELECTION_H
@@ -0,0 +1,97 @@
+#ifndef STRINGARENA_H
+#define STRINGARENA_H
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <utility>
+
+// Bump allocator for immutable strings: copies are packed into large chunks and released all at once,
+// so a table with millions of keys costs a handful of allocations instead of one per key.
+class StringArena final {
+    struct Chunk {
+        Chunk* next;
+        size_t capacity;
+    };
+
+    Chunk* head;
+    char* cursor;
+    size_t remaining;
+    size_t chunkSize;
+    size_t bytesUsed;
+    size_t chunkCount;
+
+    static char* DataOf(Chunk* chunk) { return reinterpret_cast<char*>(chunk + 1); }
+
+    void AllocateChunk(const size_t minimum) {
+        const size_t capacity = std::max(chunkSize, minimum);
+        auto* chunk = static_cast<Chunk*>(::operator new(sizeof(Chunk) + capacity));
+        chunk->next = head;
+        chunk->capacity = capacity;
+        head = chunk;
+        cursor = DataOf(chunk);
+        remaining = capacity;
+        ++chunkCount;
+    }
+
+public:
+    explicit StringArena(const size_t chunkSize = size_t{1} << 20) :
+        head(nullptr), cursor(nullptr), remaining(0), chunkSize(chunkSize), bytesUsed(0), chunkCount(0) {}
+
+    StringArena(const StringArena&) = delete;
+
+    StringArena(StringArena&& other) noexcept :
+        head(std::exchange(other.head, nullptr)), cursor(std::exchange(other.cursor, nullptr)),
+        remaining(std::exchange(other.remaining, 0)), chunkSize(other.chunkSize),
+        bytesUsed(std::exchange(other.bytesUsed, 0)), chunkCount(std::exchange(other.chunkCount, 0)) {}
+
+    StringArena& operator=(const StringArena&) = delete;
+
+    StringArena& operator=(StringArena&& other) noexcept {
+        if (this != &other) {
+            Clear();
+            head = std::exchange(other.head, nullptr);
+            cursor = std::exchange(other.cursor, nullptr);
+            remaining = std::exchange(other.remaining, 0);
+            chunkSize = other.chunkSize;
+            bytesUsed = std::exchange(other.bytesUsed, 0);
+            chunkCount = std::exchange(other.chunkCount, 0);
+        }
+        return *this;
+    }
+
+    std::string_view Store(const std::string_view text) {
+        if (text.size() > remaining) {
+            AllocateChunk(text.size());
+        }
+
+        char* destination = cursor;
+        if (!text.empty()) {
+            std::memcpy(destination, text.data(), text.size());
+        }
+        cursor += text.size();
+        remaining -= text.size();
+        bytesUsed += text.size();
+        return {destination, text.size()};
+    }
+
+    size_t GetBytesUsed() const { return bytesUsed; }
+
+    size_t GetChunkCount() const { return chunkCount; }
+
+    void Clear() {
+        while (head != nullptr) {
+            Chunk* next = head->next;
+            ::operator delete(head);
+            head = next;
+        }
+        cursor = nullptr;
+        remaining = 0;
+        bytesUsed = 0;
+        chunkCount = 0;
+    }
+
+    ~StringArena() { Clear(); }
+};
+
+#endif // STRINGARENA_H
@@ -0,0 +1,89 @@
+#ifndef SUFFIXARRAY_H
+#define SUFFIXARRAY_H
+#include <algorithm>
+#include <string_view>
+
+#include "../../sequences/arraySequence.h"
+
+class SuffixArray final {
+    std::string_view text;
+    ArraySequence<size_t> suffixes;
+    ArraySequence<size_t> lcp;
+
+    void BuildSuffixes();
+    void BuildLcp();
+
+    struct LcpInterval {
+        size_t lcp;
+        size_t leftBound;
+    };
+
+public:
+    explicit SuffixArray(std::string_view text);
+
+    size_t GetLength() const { return text.size(); }
+
+    size_t GetSuffix(const size_t index) const { return suffixes[index]; }
+
+    size_t GetLcp(const size_t index) const { return lcp[index]; }
+
+    // Visits every distinct substring with length in [lmin, lmax] exactly once as visit(first, length, count):
+    // its occurrences start at GetSuffix(first), ..., GetSuffix(first + count - 1). Internal nodes of the
+    // LCP-interval tree cover lengths (parentLcp, lcp], leaves cover the unique tails.
+    template<typename Visitor>
+    void ForEachInterval(const size_t lmin, const size_t lmax, Visitor&& visit) const {
+        const size_t n = text.size();
+        if (n == 0 || lmin > lmax) {
+            return;
+        }
+        if (lmin == 0) {
+            visit(size_t{0}, size_t{0}, n);
+        }
+
+        auto report = [&](const size_t first, const size_t parentLcp, const size_t maxLength, const size_t count) {
+            const size_t from = std::max(parentLcp + 1, lmin);
+            const size_t to = std::min(maxLength, lmax);
+            for (size_t length = from; length <= to; ++length) {
+                visit(first, length, count);
+            }
+        };
+
+        ArraySequence<LcpInterval> stack;
+        stack.Append({0, 0});
+        size_t top = 0;
+
+        for (size_t i = 1; i <= n; ++i) {
+            const size_t current = i < n ? lcp[i] : 0;
+            size_t leftBound = i - 1;
+
+            while (current < stack[top].lcp) {
+                const LcpInterval interval = stack[top--];
+                leftBound = interval.leftBound;
+                report(leftBound, std::max(current, stack[top].lcp), interval.lcp, i - leftBound);
+            }
+
+            if (current > stack[top].lcp) {
+                if (++top == stack.GetLength()) {
+                    stack.Append({current, leftBound});
+                } else {
+                    stack[top] = {current, leftBound};
+                }
+            }
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            const size_t neighbour = std::max(lcp[i], i + 1 < n ? lcp[i + 1] : 0);
+            report(i, neighbour, n - suffixes[i], 1);
+        }
+    }
+
+    // Visits every distinct substring with length in [lmin, lmax] exactly once as visit(start, length, count).
+    template<typename Visitor>
+    void ForEachSubstring(const size_t lmin, const size_t lmax, Visitor&& visit) const {
+        ForEachInterval(lmin, lmax, [&](const size_t first, const size_t length, const size_t count) {
+            visit(suffixes[first], length, count);
+        });
+    }
+};
+
+#endif // SUFFIXARRAY_H
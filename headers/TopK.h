@@ -0,0 +1,88 @@
+#ifndef TOPK_H
+#define TOPK_H
+#include <utility>
+
+#include "../../sequences/arraySequence.h"
+
+template<typename TKey>
+class TopK final {
+    using Item = std::pair<TKey, size_t>;
+
+    ArraySequence<Item> heap;
+    size_t length;
+    size_t capacity;
+
+    static bool Better(const Item& lhs, const Item& rhs) {
+        return lhs.second > rhs.second || (lhs.second == rhs.second && lhs.first < rhs.first);
+    }
+
+    static void SiftUp(ArraySequence<Item>& items, size_t index) {
+        while (index > 0) {
+            const size_t parent = (index - 1) / 2;
+            if (!Better(items[parent], items[index])) {
+                break;
+            }
+            std::swap(items[parent], items[index]);
+            index = parent;
+        }
+    }
+
+    static void SiftDown(ArraySequence<Item>& items, const size_t count, size_t index) {
+        while (true) {
+            const size_t left = 2 * index + 1;
+            const size_t right = left + 1;
+            size_t worst = index;
+            if (left < count && Better(items[worst], items[left])) {
+                worst = left;
+            }
+            if (right < count && Better(items[worst], items[right])) {
+                worst = right;
+            }
+            if (worst == index) {
+                return;
+            }
+            std::swap(items[index], items[worst]);
+            index = worst;
+        }
+    }
+
+public:
+    explicit TopK(const size_t capacity) : length(0), capacity(capacity) {}
+
+    void Push(const TKey& key, const size_t count) {
+        if (capacity == 0) {
+            return;
+        }
+
+        Item item(key, count);
+        if (length < capacity) {
+            if (length == heap.GetLength()) {
+                heap.Append(std::move(item));
+            } else {
+                heap[length] = std::move(item);
+            }
+            SiftUp(heap, length++);
+        } else if (Better(item, heap[0])) {
+            heap[0] = std::move(item);
+            SiftDown(heap, length, 0);
+        }
+    }
+
+    size_t GetCount() const { return length; }
+
+    size_t GetCapacity() const { return capacity; }
+
+    // Items ordered by count descending, ties broken by key ascending.
+    ArraySequence<Item> GetSorted() const {
+        ArraySequence<Item> items = heap;
+        ArraySequence<Item> result(length);
+        for (size_t count = length; count > 0; --count) {
+            result[count - 1] = items[0];
+            std::swap(items[0], items[count - 1]);
+            SiftDown(items, count - 1, 0);
+        }
+        return result;
+    }
+};
+
+#endif // TOPK_H
@@ -0,0 +1,69 @@
+#ifndef WORDNGRAMS_H
+#define WORDNGRAMS_H
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "../../sequences/arraySequence.h"
+#include "FNV1aHash.h"
+#include "IDictionary.h"
+
+using TokenId = uint32_t;
+
+// The text as a sequence of token IDs. Every distinct token is interned once; its text stays a view into the
+// tokenized string, which must outlive the TokenizedText. Tokens are maximal runs of letters and digits: ASCII
+// whitespace and punctuation, Latin-1 punctuation (U+00A0..U+00BF) and General Punctuation (U+2000..U+206F)
+// separate them, every other byte belongs to a token.
+class TokenizedText final {
+    ArraySequence<TokenId> ids;
+    ArraySequence<std::string_view> vocabulary;
+
+public:
+    explicit TokenizedText(std::string_view text);
+
+    size_t GetLength() const { return ids.GetLength(); }
+
+    TokenId GetId(const size_t index) const { return ids[index]; }
+
+    size_t GetVocabularySize() const { return vocabulary.GetLength(); }
+
+    std::string_view GetToken(const TokenId id) const { return vocabulary[id]; }
+};
+
+// Up to maxLength consecutive token IDs; unused positions stay zero so equal n-grams compare equal as arrays.
+struct TokenNGram {
+    static constexpr size_t maxLength = 8;
+
+    std::array<TokenId, maxLength> tokens{};
+    size_t length = 0;
+
+    bool operator==(const TokenNGram& other) const { return length == other.length && tokens == other.tokens; }
+
+    bool operator!=(const TokenNGram& other) const { return !(*this == other); }
+
+    bool operator<(const TokenNGram& other) const {
+        return tokens != other.tokens ? tokens < other.tokens : length < other.length;
+    }
+
+    // Appends the tokens separated by single spaces.
+    void AppendText(const TokenizedText& text, std::string& target) const;
+};
+
+template<template<typename> class IntegerHash = FNV1a>
+struct TokenNGramHash {
+    size_t operator()(const TokenNGram& key) const {
+        size_t hash = 0xcbf29ce484222325UL;
+        for (size_t i = 0; i < key.length; ++i) {
+            hash = (hash ^ IntegerHash<TokenId>{}(key.tokens[i])) * 0x100000001b3UL;
+        }
+        return hash ^ hash >> 32;
+    }
+};
+
+using NGramTable = IDictionary<TokenNGram, size_t, TokenNGramHash<>>;
+
+// Counts every run of lmin..lmax consecutive tokens; lmax is at most TokenNGram::maxLength.
+NGramTable createNGramTable(const TokenizedText& text, size_t lmin, size_t lmax);
+
+#endif // WORDNGRAMS_H
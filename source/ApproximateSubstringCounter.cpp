@@ -0,0 +1,123 @@
+#include "../headers/ApproximateSubstringCounter.h"
+
+#include <stdexcept>
+
+#include "../headers/TopK.h"
+#include "../../sorting/quickSort.h"
+
+namespace {
+    using Candidate = std::pair<std::string_view, size_t>;
+
+    constexpr size_t arenaChunkSize = size_t{1} << 16;
+} // namespace
+
+ApproximateSubstringCounter::ApproximateSubstringCounter(const size_t lmin, const size_t lmax, const size_t k,
+                                                         const double epsilon, const double delta) :
+    lmin(lmin), lmax(lmax), k(k), sketch(epsilon, delta), arena(arenaChunkSize) {
+    if (lmin == 0 || lmin > lmax) {
+        throw std::out_of_range("Invalid indices");
+    }
+    if (k == 0) {
+        throw std::invalid_argument("Approximate counting needs a positive K");
+    }
+
+    candidates = ArraySequence<CandidateTable>(lmax - lmin + 1);
+    thresholds = ArraySequence<size_t>(lmax - lmin + 1);
+    for (auto& table: candidates) {
+        table.Reserve(2 * k);
+    }
+}
+
+void ApproximateSubstringCounter::CountWindows(const std::string_view text, const size_t startEnd) {
+    for (size_t start = 0; start < startEnd; ++start) {
+        for (size_t len = lmin; len <= lmax && start + len <= text.size(); ++len) {
+            const std::string_view window = text.substr(start, len);
+            const size_t estimate = sketch.Add(window);
+
+            CandidateTable& table = candidates[len - lmin];
+            if (size_t* stored = table.Find(window)) {
+                *stored = estimate;
+            } else if (estimate > thresholds[len - lmin]) {
+                table.Insert(arena.Store(window), estimate);
+                liveBytes += len;
+                if (table.GetCount() >= 2 * k) {
+                    Prune(len);
+                }
+            }
+        }
+    }
+}
+
+void ApproximateSubstringCounter::Prune(const size_t length) {
+    CandidateTable& table = candidates[length - lmin];
+    ArraySequence<Candidate> entries(table.GetCount());
+    size_t position = 0;
+    for (const auto& entry: table) {
+        entries[position++] = entry;
+    }
+
+    QuickSorter<Candidate> sorter;
+    sorter.Sort(entries, [](const Candidate& left, const Candidate& right) { return left.second > right.second; });
+
+    CandidateTable kept;
+    kept.Reserve(2 * k);
+    for (size_t index = 0; index < k; ++index) {
+        kept.Insert(entries[index].first, entries[index].second);
+    }
+    thresholds[length - lmin] = entries[k - 1].second;
+    liveBytes -= (entries.GetLength() - k) * length;
+    table = std::move(kept);
+
+    // Keys dropped by pruning stay in the arena until it is rebuilt from the live candidates.
+    if (arena.GetBytesUsed() > 4 * liveBytes + arenaChunkSize) {
+        Compact();
+    }
+}
+
+void ApproximateSubstringCounter::Compact() {
+    StringArena compacted(arenaChunkSize);
+    for (auto& table: candidates) {
+        CandidateTable moved;
+        moved.Reserve(2 * k);
+        for (const auto& [key, estimate]: table) {
+            moved.Insert(compacted.Store(key), estimate);
+        }
+        table = std::move(moved);
+    }
+    arena = std::move(compacted);
+}
+
+void ApproximateSubstringCounter::Feed(const std::string_view chunk) {
+    totalBytes += chunk.size();
+    pending.append(chunk);
+
+    // The last lmax - 1 bytes may still begin windows that end in the next chunk.
+    const size_t carry = lmax - 1;
+    if (pending.size() <= carry) {
+        return;
+    }
+    const size_t startEnd = pending.size() - carry;
+    CountWindows(pending, startEnd);
+    pending.erase(0, startEnd);
+}
+
+ArraySequence<ArraySequence<std::pair<std::string, size_t>>> ApproximateSubstringCounter::Finish() {
+    CountWindows(pending, pending.size());
+    pending.clear();
+
+    // Stored estimates are taken when a key was last seen; other keys may have raised its counters since.
+    ArraySequence<ArraySequence<std::pair<std::string, size_t>>> result;
+    for (auto& table: candidates) {
+        TopK<std::string_view> heap(k);
+        for (const auto& entry: table) {
+            heap.Push(entry.first, sketch.Estimate(entry.first));
+        }
+
+        ArraySequence<std::pair<std::string, size_t>> top;
+        for (const auto& [key, count]: heap.GetSorted()) {
+            top.Append({std::string(key), count});
+        }
+        result.Append(std::move(top));
+    }
+    return result;
+}
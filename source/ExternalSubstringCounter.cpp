@@ -0,0 +1,257 @@
+#include "../headers/ExternalSubstringCounter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#include "../../sorting/quickSort.h"
+
+namespace {
+    using Entry = std::pair<std::string_view, size_t>;
+
+    // Table slot, cached hash, control byte and fingerprint of one IDictionary entry.
+    constexpr size_t slotBytes = sizeof(Entry) + sizeof(size_t) + 2;
+    constexpr size_t maxArenaChunk = size_t{1} << 20;
+
+    size_t tableCapacityFor(const size_t memoryBudget) {
+        size_t capacity = 16;
+        while (capacity * 2 * slotBytes <= memoryBudget / 2) {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    void writeEntry(std::ofstream& stream, const std::string_view key, const size_t count) {
+        const size_t length = key.size();
+        stream.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        stream.write(key.data(), static_cast<std::streamsize>(length));
+        stream.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    }
+
+    template<typename Table>
+    ArraySequence<const Entry*> sortedEntries(Table& table) {
+        ArraySequence<const Entry*> entries(table.GetCount());
+        size_t position = 0;
+        for (const auto& entry: table) {
+            entries[position++] = &entry;
+        }
+        QuickSorter<const Entry*> sorter;
+        sorter.Sort(entries,
+                    [](const Entry* const& left, const Entry* const& right) { return left->first < right->first; });
+        return entries;
+    }
+
+    struct RunReader {
+        std::ifstream stream;
+        std::string key;
+        size_t count = 0;
+
+        bool Next() {
+            size_t length;
+            if (!stream.read(reinterpret_cast<char*>(&length), sizeof(length))) {
+                return false;
+            }
+            key.resize(length);
+            stream.read(key.data(), static_cast<std::streamsize>(length));
+            stream.read(reinterpret_cast<char*>(&count), sizeof(count));
+            if (!stream) {
+                throw std::runtime_error("Corrupted spill file.");
+            }
+            return true;
+        }
+    };
+
+    void siftDown(ArraySequence<size_t>& heap, const size_t size, size_t index,
+                  const ArraySequence<RunReader>& readers) {
+        while (true) {
+            const size_t left = 2 * index + 1;
+            const size_t right = left + 1;
+            size_t smallest = index;
+            if (left < size && readers[heap[left]].key < readers[heap[smallest]].key) {
+                smallest = left;
+            }
+            if (right < size && readers[heap[right]].key < readers[heap[smallest]].key) {
+                smallest = right;
+            }
+            if (smallest == index) {
+                return;
+            }
+            std::swap(heap[index], heap[smallest]);
+            index = smallest;
+        }
+    }
+} // namespace
+
+ExternalSubstringCounter::ExternalSubstringCounter(const size_t lmin, const size_t lmax, const size_t memoryBudget,
+                                                   const std::filesystem::path& temporaryDirectory) :
+    lmin(lmin), lmax(lmax), entryLimit(0), arenaLimit(0),
+    arena(std::clamp<size_t>(memoryBudget / 8, size_t{1} << 12, maxArenaChunk)) {
+    if (lmin > lmax) {
+        throw std::out_of_range("Invalid indices");
+    }
+
+    // Half of the budget goes to the table, which is allocated once and never grows; the arena gets the rest,
+    // minus one chunk of slack because the last chunk is only partly used.
+    const size_t capacity = tableCapacityFor(memoryBudget);
+    entryLimit = capacity * 9 / 10;
+    const size_t tableBytes = capacity * slotBytes;
+    const size_t reserved = tableBytes + maxArenaChunk;
+    arenaLimit = memoryBudget > reserved ? memoryBudget - reserved : size_t{1} << 12;
+    table.Reserve(entryLimit);
+
+    const auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    spillDirectory = temporaryDirectory / ("lab3-spill-" + std::to_string(stamp) + "-" +
+                                           std::to_string(reinterpret_cast<std::uintptr_t>(this)));
+}
+
+ExternalSubstringCounter::~ExternalSubstringCounter() {
+    std::error_code error;
+    std::filesystem::remove_all(spillDirectory, error);
+}
+
+void ExternalSubstringCounter::CountWindows(const std::string_view text, const size_t startEnd) {
+    for (size_t start = 0; start < startEnd; ++start) {
+        for (size_t len = lmin; len <= lmax && start + len <= text.size(); ++len) {
+            if (table.GetCount() >= entryLimit || arena.GetBytesUsed() >= arenaLimit) {
+                Spill();
+            }
+            const std::string_view window = text.substr(start, len);
+            ++table.FindOrInsertWith(window, [&] { return arena.Store(window); }, 0);
+        }
+    }
+}
+
+void ExternalSubstringCounter::Feed(const std::string_view chunk) {
+    totalBytes += chunk.size();
+    pending.append(chunk);
+
+    // The last lmax - 1 bytes may still begin windows that end in the next chunk.
+    const size_t carry = lmax > 0 ? lmax - 1 : 0;
+    if (pending.size() <= carry) {
+        return;
+    }
+    const size_t startEnd = pending.size() - carry;
+    CountWindows(pending, startEnd);
+    pending.erase(0, startEnd);
+}
+
+std::filesystem::path ExternalSubstringCounter::NextRunPath() {
+    if (runsCreated == 0) {
+        std::filesystem::create_directories(spillDirectory);
+    }
+    return spillDirectory / ("run-" + std::to_string(runsCreated++) + ".bin");
+}
+
+void ExternalSubstringCounter::Spill() {
+    if (table.GetCount() == 0) {
+        return;
+    }
+
+    const ArraySequence<const Entry*> entries = sortedEntries(table);
+    const std::filesystem::path path = NextRunPath();
+    std::ofstream stream(path, std::ios::binary);
+    if (!stream) {
+        throw std::runtime_error("Failed to create spill file.");
+    }
+    for (const Entry* entry: entries) {
+        writeEntry(stream, entry->first, entry->second);
+    }
+    stream.close();
+    if (!stream) {
+        throw std::runtime_error("Failed to write spill file.");
+    }
+    runs.Append(path);
+
+    table = Table();
+    table.Reserve(entryLimit);
+    arena.Clear();
+}
+
+void ExternalSubstringCounter::MergeRuns(const ArraySequence<std::filesystem::path>& group,
+                                         const std::function<void(std::string_view, size_t)>& visit) const {
+    const size_t runCount = group.GetLength();
+    ArraySequence<RunReader> readers(runCount);
+    ArraySequence<size_t> heap(runCount);
+    size_t size = 0;
+
+    for (size_t run = 0; run < runCount; ++run) {
+        readers[run].stream.open(group[run], std::ios::binary);
+        if (!readers[run].stream) {
+            throw std::runtime_error("Failed to open spill file.");
+        }
+        if (readers[run].Next()) {
+            heap[size++] = run;
+        }
+    }
+    for (size_t index = size / 2; index-- > 0;) {
+        siftDown(heap, size, index, readers);
+    }
+
+    std::string key;
+    while (size > 0) {
+        key = readers[heap[0]].key;
+        size_t total = 0;
+        while (size > 0 && readers[heap[0]].key == key) {
+            total += readers[heap[0]].count;
+            if (!readers[heap[0]].Next()) {
+                heap[0] = heap[--size];
+            }
+            siftDown(heap, size, 0, readers);
+        }
+        visit(key, total);
+    }
+}
+
+void ExternalSubstringCounter::Finish(const std::function<void(std::string_view, size_t)>& visit) {
+    CountWindows(pending, pending.size());
+    pending.clear();
+
+    if (runs.GetLength() == 0) {
+        for (const Entry* entry: sortedEntries(table)) {
+            visit(entry->first, entry->second);
+        }
+    } else {
+        Spill();
+
+        // Merge passes keep the number of simultaneously open run files bounded by mergeFanIn.
+        while (runs.GetLength() > mergeFanIn) {
+            ArraySequence<std::filesystem::path> merged;
+            for (size_t first = 0; first < runs.GetLength(); first += mergeFanIn) {
+                ArraySequence<std::filesystem::path> group;
+                for (size_t run = first; run < std::min(first + mergeFanIn, runs.GetLength()); ++run) {
+                    group.Append(runs[run]);
+                }
+
+                const std::filesystem::path path = NextRunPath();
+                std::ofstream stream(path, std::ios::binary);
+                if (!stream) {
+                    throw std::runtime_error("Failed to create spill file.");
+                }
+                MergeRuns(group,
+                          [&](const std::string_view key, const size_t count) { writeEntry(stream, key, count); });
+                stream.close();
+                if (!stream) {
+                    throw std::runtime_error("Failed to write spill file.");
+                }
+                for (const auto& run: group) {
+                    std::filesystem::remove(run);
+                }
+                merged.Append(path);
+            }
+            runs = merged;
+        }
+
+        MergeRuns(runs, visit);
+        for (const auto& run: runs) {
+            std::filesystem::remove(run);
+        }
+        runs = ArraySequence<std::filesystem::path>();
+    }
+
+    table = Table();
+    table.Reserve(entryLimit);
+    arena.Clear();
+}
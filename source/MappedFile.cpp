@@ -0,0 +1,144 @@
+#include "../headers/MappedFile.h"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iostream>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr size_t readBlockSize = size_t{1} << 20;
+
+#ifdef _WIN32
+    void readStream(std::istream& stream, std::string& buffer) {
+        size_t length = 0;
+        while (stream) {
+            buffer.resize(length + readBlockSize);
+            stream.read(buffer.data() + length, readBlockSize);
+            length += static_cast<size_t>(stream.gcount());
+        }
+        buffer.resize(length);
+    }
+#else
+    void readDescriptor(const int descriptor, std::string& buffer) {
+        size_t length = 0;
+        while (true) {
+            buffer.resize(length + readBlockSize);
+            const ssize_t count = ::read(descriptor, buffer.data() + length, readBlockSize);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count < 0) {
+                throw std::runtime_error("Failed to read input file.");
+            }
+            if (count == 0) {
+                break;
+            }
+            length += static_cast<size_t>(count);
+        }
+        buffer.resize(length);
+    }
+#endif
+} // namespace
+
+MappedFile::MappedFile(const std::string& path, const AccessPattern pattern) {
+#ifdef _WIN32
+    (void) pattern;
+    if (path == "-") {
+        readStream(std::cin, buffer);
+    } else {
+        std::ifstream stream(path, std::ios::binary);
+        if (!stream) {
+            throw std::runtime_error("Failed to open input file.");
+        }
+        readStream(stream, buffer);
+    }
+    data = buffer.data();
+    size = buffer.size();
+#else
+    const bool standardInput = path == "-";
+    const int descriptor = standardInput ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error("Failed to open input file.");
+    }
+
+    struct stat status {};
+    if (::fstat(descriptor, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0) {
+        const auto length = static_cast<size_t>(status.st_size);
+        void* address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (address != MAP_FAILED) {
+            ::madvise(address, length, pattern == AccessPattern::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+            data = static_cast<const char*>(address);
+            size = length;
+            mapped = true;
+        }
+    }
+
+    if (!mapped) {
+        try {
+            readDescriptor(descriptor, buffer);
+        } catch (...) {
+            if (!standardInput) {
+                ::close(descriptor);
+            }
+            throw;
+        }
+        data = buffer.data();
+        size = buffer.size();
+    }
+
+    // The mapping stays valid after the descriptor is closed.
+    if (!standardInput) {
+        ::close(descriptor);
+    }
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+    data(other.data), size(other.size), mapped(other.mapped), buffer(std::move(other.buffer)) {
+    if (!mapped) {
+        data = buffer.data();
+    }
+    other.data = nullptr;
+    other.size = 0;
+    other.mapped = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Release();
+        data = other.data;
+        size = other.size;
+        mapped = other.mapped;
+        buffer = std::move(other.buffer);
+        if (!mapped) {
+            data = buffer.data();
+        }
+        other.data = nullptr;
+        other.size = 0;
+        other.mapped = false;
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() { Release(); }
+
+void MappedFile::Release() {
+#ifndef _WIN32
+    if (mapped) {
+        ::munmap(const_cast<char*>(data), size);
+    }
+#endif
+    data = nullptr;
+    size = 0;
+    mapped = false;
+    buffer.clear();
+}
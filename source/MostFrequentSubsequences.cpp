@@ -1,57 +1,665 @@
 #include "../headers/MostFrequentSubsequences.h"
 
 #include <filesystem>
+#include <iostream>
+#include <limits>
 
-IDictionary<std::string, size_t, FNV1a<std::string>> createPrefixTable(const std::string& str, const size_t lmin,
-                                                                       const size_t lmax) {
-    IDictionary<std::string, size_t, FNV1a<std::string>> table;
-    const size_t n = str.size();
+#include "../headers/ApproximateSubstringCounter.h"
+#include "../headers/ExternalSubstringCounter.h"
+#include "../headers/MappedFile.h"
+#include "../headers/Parallel.h"
+#include "../headers/SuffixArray.h"
+#include "../headers/TopK.h"
+#include "../headers/WordNGrams.h"
+#include "../../sorting/quickSort.h"
 
-    if (lmin > lmax || str.empty()) {
-        throw std::out_of_range("Invalid indices");
+namespace {
+    struct Occurrence {
+        size_t count = 0;
+        size_t first = 0;
+    };
+
+    using OccurrenceTable = IDictionary<std::string, Occurrence, FNV1a<std::string>>;
+    using OccurrenceEntry = std::pair<std::string, Occurrence>;
+
+    size_t shardOf(const std::string& key, const size_t shardCount) {
+        return (FNV1a<std::string>{}(key) >> 32) % shardCount;
+    }
+
+    template<typename Key>
+    void countingSort(const ArraySequence<const OccurrenceEntry*>& source,
+                      ArraySequence<const OccurrenceEntry*>& target, const size_t buckets, Key&& key) {
+        ArraySequence<size_t> offsets(buckets + 1);
+        for (const OccurrenceEntry* entry: source) {
+            ++offsets[key(*entry) + 1];
+        }
+        for (size_t bucket = 1; bucket <= buckets; ++bucket) {
+            offsets[bucket] += offsets[bucket - 1];
+        }
+        for (const OccurrenceEntry* entry: source) {
+            target[offsets[key(*entry)]++] = entry;
+        }
+    }
+
+    // Views the text one byte per character; CodePointIndex is the UTF-8 counterpart with the same interface.
+    class ByteIndex final {
+        std::string_view text;
+
+    public:
+        static size_t LengthOf(const std::string_view bytes) { return bytes.size(); }
+
+        explicit ByteIndex(const std::string_view text) : text(text) {}
+
+        std::string_view GetText() const { return text; }
+
+        size_t GetLength() const { return text.size(); }
+
+        std::string_view Slice(const size_t start, const size_t length) const { return text.substr(start, length); }
+    };
+
+    // The result tables grow by incremental rehash, so no single insertion pays for moving a large table.
+    constexpr bool incrementalResults = true;
+
+    template<typename Text>
+    void checkRange(const Text& text, const size_t lmin, const size_t lmax) {
+        if (lmin > lmax || text.GetLength() == 0) {
+            throw std::out_of_range("Invalid indices");
+        }
     }
 
-    for (size_t start = 0; start < n; ++start) {
-        for (size_t len = lmin; len <= lmax && start + len <= n; ++len) {
-            if (std::string substr = str.substr(start, len); table.Contains(substr)) {
-                ++table[substr];
-            } else {
-                table.Insert(substr, 1);
+    template<typename Text>
+    IDictionary<std::string, size_t, FNV1a<std::string>> countSubstrings(const Text& text, const size_t lmin,
+                                                                        const size_t lmax) {
+        IDictionary<std::string, size_t, FNV1a<std::string>> table(16, 0.9, incrementalResults);
+        const size_t n = text.GetLength();
+        checkRange(text, lmin, lmax);
+
+        for (size_t start = 0; start < n; ++start) {
+            for (size_t len = lmin; len <= lmax && start + len <= n; ++len) {
+                ++table.FindOrInsert(std::string(text.Slice(start, len)), 0);
             }
         }
+
+        return table;
     }
 
-    return table;
+    template<typename Text>
+    IDictionary<std::string_view, size_t, FNV1a<std::string_view>>
+    countSubstringsArena(const Text& text, const size_t lmin, const size_t lmax, StringArena& arena) {
+        IDictionary<std::string_view, size_t, FNV1a<std::string_view>> table(16, 0.9, incrementalResults);
+        const size_t n = text.GetLength();
+        checkRange(text, lmin, lmax);
+
+        for (size_t start = 0; start < n; ++start) {
+            for (size_t len = lmin; len <= lmax && start + len <= n; ++len) {
+                const std::string_view window = text.Slice(start, len);
+                ++table.FindOrInsertWith(window, [&] { return arena.Store(window); }, 0);
+            }
+        }
+
+        return table;
+    }
+
+    template<typename Text>
+    IDictionary<std::string, size_t, FNV1a<std::string>> countSubstringsParallel(const Text& text, const size_t lmin,
+                                                                                const size_t lmax,
+                                                                                const size_t threadCount) {
+        checkRange(text, lmin, lmax);
+
+        const size_t n = text.GetLength();
+        const size_t workers = std::min(resolveThreadCount(threadCount), n);
+        if (workers == 1) {
+            return countSubstrings(text, lmin, lmax);
+        }
+
+        // Worker w owns the start positions [w * chunk, (w + 1) * chunk) and reads up to lmax - 1 characters past
+        // its chunk, so every (start, len) pair is counted by exactly one worker.
+        const size_t chunk = (n + workers - 1) / workers;
+        ArraySequence<ArraySequence<OccurrenceTable>> local(workers);
+
+        parallelFor(workers, [&](const size_t worker) {
+            ArraySequence<OccurrenceTable> shards(workers);
+            const size_t end = std::min(n, (worker + 1) * chunk);
+
+            for (size_t start = worker * chunk; start < end; ++start) {
+                for (size_t len = lmin; len <= lmax && start + len <= n; ++len) {
+                    std::string substr(text.Slice(start, len));
+                    ++shards[shardOf(substr, workers)].FindOrInsert(substr, {0, start}).count;
+                }
+            }
+
+            local[worker] = std::move(shards);
+        });
+
+        ArraySequence<OccurrenceTable> merged(workers);
+        parallelFor(workers, [&](const size_t shard) {
+            OccurrenceTable& target = merged[shard];
+            for (size_t worker = 0; worker < workers; ++worker) {
+                for (const auto& [key, occurrence]: local[worker][shard]) {
+                    Occurrence& total = target.FindOrInsert(key, {0, occurrence.first});
+                    total.count += occurrence.count;
+                    total.first = std::min(total.first, occurrence.first);
+                }
+                local[worker][shard] = OccurrenceTable();
+            }
+        });
+
+        size_t distinct = 0;
+        for (const auto& shard: merged) {
+            distinct += shard.GetCount();
+        }
+
+        ArraySequence<const OccurrenceEntry*> entries(distinct);
+        size_t position = 0;
+        for (auto& shard: merged) {
+            for (const auto& entry: shard) {
+                entries[position++] = &entry;
+            }
+        }
+
+        // Replaying the keys in order of first occurrence reproduces the serial insertion sequence,
+        // so the resulting table has the same layout and iteration order as createPrefixTable.
+        ArraySequence<const OccurrenceEntry*> byLength(distinct);
+        countingSort(entries, byLength, lmax - lmin + 1,
+                     [lmin](const OccurrenceEntry& entry) { return Text::LengthOf(entry.first) - lmin; });
+        countingSort(byLength, entries, n, [](const OccurrenceEntry& entry) { return entry.second.first; });
+
+        IDictionary<std::string, size_t, FNV1a<std::string>> table(16, 0.9, incrementalResults);
+        for (const OccurrenceEntry* entry: entries) {
+            table.Insert(entry->first, entry->second.count);
+        }
+
+        return table;
+    }
+
+    template<typename Text>
+    IDictionary<SubstringView, size_t, SubstringViewHash> countSubstringsRolling(const Text& text, const size_t lmin,
+                                                                                const size_t lmax) {
+        IDictionary<SubstringView, size_t, SubstringViewHash> table(16, 0.9, incrementalResults);
+        const size_t n = text.GetLength();
+        checkRange(text, lmin, lmax);
+
+        // The hash always covers the bytes of the window, so byte and code point windows share one hash.
+        for (size_t start = 0; start < n; ++start) {
+            uint64_t hash = 0;
+            size_t hashed = 0;
+            for (size_t len = 1; len <= lmax && start + len <= n; ++len) {
+                const std::string_view window = text.Slice(start, len);
+                for (; hashed < window.size(); ++hashed) {
+                    hash = RollingHash::Extend(hash, static_cast<unsigned char>(window[hashed]));
+                }
+                if (len < lmin) {
+                    continue;
+                }
+
+                ++table.FindOrInsert({window, hash}, 0);
+            }
+        }
+
+        return table;
+    }
+
+    template<typename Visitor>
+    void forEachSubstring(const SuffixArray& suffixArray, const ByteIndex&, const size_t lmin, const size_t lmax,
+                          Visitor&& visit) {
+        suffixArray.ForEachSubstring(lmin, lmax, visit);
+    }
+
+    // The suffix array is built over bytes, so it visits byte strings of up to lmax times the longest code point and
+    // keeps those that start on a code point boundary. Whether an occurrence also ends on one depends on the byte
+    // after it. In well-formed UTF-8 the bytes of the substring alone decide that, so checking one occurrence covers
+    // all of them; otherwise every occurrence is checked and only those ending on a boundary are counted.
+    template<typename Visitor>
+    void forEachSubstring(const SuffixArray& suffixArray, const CodePointIndex& index, const size_t lmin,
+                          const size_t lmax, Visitor&& visit) {
+        const std::string_view text = index.GetText();
+        const size_t longest = std::max<size_t>(index.GetLongestCodePoint(), 1);
+        const size_t maxBytes = std::min(lmax, std::numeric_limits<size_t>::max() / longest) * longest;
+        auto endsOnBoundary = [&](const size_t start, const size_t length) {
+            return start + length == text.size() || !CodePointIndex::IsContinuation(text[start + length]);
+        };
+
+        suffixArray.ForEachInterval(lmin, maxBytes, [&](const size_t first, const size_t length, const size_t count) {
+            const size_t start = suffixArray.GetSuffix(first);
+            if (CodePointIndex::IsContinuation(text[start])) {
+                return;
+            }
+            const size_t units = CodePointIndex::LengthOf(text.substr(start, length));
+            if (units < lmin || units > lmax) {
+                return;
+            }
+
+            if (index.IsWellFormed()) {
+                if (endsOnBoundary(start, length)) {
+                    visit(start, length, count);
+                }
+                return;
+            }
+            size_t whole = 0;
+            for (size_t occurrence = first; occurrence < first + count; ++occurrence) {
+                whole += endsOnBoundary(suffixArray.GetSuffix(occurrence), length);
+            }
+            if (whole > 0) {
+                visit(start, length, whole);
+            }
+        });
+    }
+
+    template<typename Text>
+    IDictionary<std::string, size_t, FNV1a<std::string>> countSubstringsSuffixArray(const Text& text,
+                                                                                   const size_t lmin,
+                                                                                   const size_t lmax) {
+        IDictionary<std::string, size_t, FNV1a<std::string>> table(16, 0.9, incrementalResults);
+        checkRange(text, lmin, lmax);
+
+        const std::string_view str = text.GetText();
+        const SuffixArray suffixArray(str);
+        forEachSubstring(suffixArray, text, lmin, lmax,
+                         [&](const size_t start, const size_t length, const size_t count) {
+                             table.Insert(std::string(str.substr(start, length)), count);
+                         });
+
+        return table;
+    }
+
+    template<typename Text>
+    ArraySequence<ArraySequence<std::pair<std::string, size_t>>>
+    findMostFrequent(const Text& text, const size_t lmin, const size_t lmax, const size_t k,
+                     const CountingEngine engine) {
+        checkRange(text, lmin, lmax);
+
+        ArraySequence<TopK<std::string_view>> heaps;
+        for (size_t length = lmin; length <= lmax; ++length) {
+            heaps.Append(TopK<std::string_view>(k));
+        }
+
+        auto collect = [&] {
+            ArraySequence<ArraySequence<std::pair<std::string, size_t>>> result;
+            for (const auto& heap: heaps) {
+                ArraySequence<std::pair<std::string, size_t>> top;
+                for (const auto& [key, count]: heap.GetSorted()) {
+                    top.Append({std::string(key), count});
+                }
+                result.Append(std::move(top));
+            }
+            return result;
+        };
+
+        switch (engine) {
+            case CountingEngine::HashTable: {
+                IDictionary<std::string, size_t, FNV1a<std::string>> table = countSubstrings(text, lmin, lmax);
+                for (const auto& [key, value]: table) {
+                    heaps[Text::LengthOf(key) - lmin].Push(key, value);
+                }
+                return collect();
+            }
+            case CountingEngine::RollingHash: {
+                IDictionary<SubstringView, size_t, SubstringViewHash> table = countSubstringsRolling(text, lmin, lmax);
+                for (const auto& [key, value]: table) {
+                    heaps[Text::LengthOf(key.text) - lmin].Push(key.text, value);
+                }
+                return collect();
+            }
+            case CountingEngine::SuffixArray: {
+                const std::string_view str = text.GetText();
+                const SuffixArray suffixArray(str);
+                forEachSubstring(suffixArray, text, lmin, lmax,
+                                 [&](const size_t start, const size_t length, const size_t count) {
+                                     const std::string_view key = str.substr(start, length);
+                                     heaps[Text::LengthOf(key) - lmin].Push(key, count);
+                                 });
+                return collect();
+            }
+        }
+
+        throw std::invalid_argument("Unknown counting engine");
+    }
+
+    // Ties are broken by token IDs, i.e. roughly by first occurrence, since the n-grams have no text until collected.
+    ArraySequence<ArraySequence<std::pair<std::string, size_t>>>
+    findMostFrequentNGrams(const std::string_view str, const size_t lmin, const size_t lmax, const size_t k) {
+        const TokenizedText text(str);
+        NGramTable table = createNGramTable(text, lmin, lmax);
+
+        ArraySequence<TopK<TokenNGram>> heaps;
+        for (size_t length = lmin; length <= lmax; ++length) {
+            heaps.Append(TopK<TokenNGram>(k));
+        }
+        for (const auto& [key, value]: table) {
+            heaps[key.length - lmin].Push(key, value);
+        }
+
+        ArraySequence<ArraySequence<std::pair<std::string, size_t>>> result;
+        for (const auto& heap: heaps) {
+            ArraySequence<std::pair<std::string, size_t>> top;
+            for (const auto& [key, count]: heap.GetSorted()) {
+                std::string joined;
+                key.AppendText(text, joined);
+                top.Append({std::move(joined), count});
+            }
+            result.Append(std::move(top));
+        }
+        return result;
+    }
+} // namespace
+
+IDictionary<std::string, size_t, FNV1a<std::string>> createPrefixTable(const std::string_view str, const size_t lmin,
+                                                                       const size_t lmax) {
+    return countSubstrings(ByteIndex(str), lmin, lmax);
 }
 
-void processFileAndSaveResults(const std::string& inputFile, const std::string& outputDirectory, size_t lmin,
-                               size_t lmax) {
-    std::ifstream inFile(inputFile);
-    if (!inFile) {
-        throw std::runtime_error("Failed to open input file.");
+IDictionary<std::string, size_t, FNV1a<std::string>> createPrefixTable(const CodePointIndex& text, const size_t lmin,
+                                                                       const size_t lmax) {
+    return countSubstrings(text, lmin, lmax);
+}
+
+IDictionary<std::string_view, size_t, FNV1a<std::string_view>> createPrefixTableArena(const std::string_view str,
+                                                                                     const size_t lmin,
+                                                                                     const size_t lmax,
+                                                                                     StringArena& arena) {
+    return countSubstringsArena(ByteIndex(str), lmin, lmax, arena);
+}
+
+IDictionary<std::string_view, size_t, FNV1a<std::string_view>> createPrefixTableArena(const CodePointIndex& text,
+                                                                                     const size_t lmin,
+                                                                                     const size_t lmax,
+                                                                                     StringArena& arena) {
+    return countSubstringsArena(text, lmin, lmax, arena);
+}
+
+IDictionary<std::string, size_t, FNV1a<std::string>> createPrefixTableParallel(const std::string_view str,
+                                                                               const size_t lmin, const size_t lmax,
+                                                                               const size_t threadCount) {
+    return countSubstringsParallel(ByteIndex(str), lmin, lmax, threadCount);
+}
+
+IDictionary<std::string, size_t, FNV1a<std::string>> createPrefixTableParallel(const CodePointIndex& text,
+                                                                               const size_t lmin, const size_t lmax,
+                                                                               const size_t threadCount) {
+    return countSubstringsParallel(text, lmin, lmax, threadCount);
+}
+
+IDictionary<SubstringView, size_t, SubstringViewHash> createPrefixTableRolling(const std::string_view str,
+                                                                               const size_t lmin, const size_t lmax) {
+    return countSubstringsRolling(ByteIndex(str), lmin, lmax);
+}
+
+IDictionary<SubstringView, size_t, SubstringViewHash> createPrefixTableRolling(const CodePointIndex& text,
+                                                                               const size_t lmin, const size_t lmax) {
+    return countSubstringsRolling(text, lmin, lmax);
+}
+
+IDictionary<std::string, size_t, FNV1a<std::string>> createPrefixTableSuffixArray(const std::string_view str,
+                                                                                  const size_t lmin,
+                                                                                  const size_t lmax) {
+    return countSubstringsSuffixArray(ByteIndex(str), lmin, lmax);
+}
+
+IDictionary<std::string, size_t, FNV1a<std::string>> createPrefixTableSuffixArray(const CodePointIndex& text,
+                                                                                  const size_t lmin,
+                                                                                  const size_t lmax) {
+    return countSubstringsSuffixArray(text, lmin, lmax);
+}
+
+ArraySequence<ArraySequence<std::pair<std::string, size_t>>>
+findMostFrequentSubsequences(const std::string_view str, const size_t lmin, const size_t lmax, const size_t k,
+                             const CountingEngine engine, const TextUnit unit) {
+    if (unit == TextUnit::Word) {
+        return findMostFrequentNGrams(str, lmin, lmax, k);
+    }
+    if (unit == TextUnit::CodePoint) {
+        return findMostFrequent(CodePointIndex(str), lmin, lmax, k, engine);
+    }
+    return findMostFrequent(ByteIndex(str), lmin, lmax, k, engine);
+}
+
+namespace {
+    constexpr size_t streamChunkSize = size_t{1} << 20;
+    constexpr char approximationReportName[] = "approximation.txt";
+
+    using ResultEntry = ResultWriter::Entry;
+
+    std::filesystem::path resultPath(const std::string& outputDirectory, const OutputFormat format) {
+        std::filesystem::path outputPath(outputDirectory);
+        if (!exists(outputPath)) {
+            create_directories(outputPath);
+        }
+        return outputPath / ResultWriter::FileName(format);
+    }
+
+    void sortResults(ArraySequence<ResultEntry>& entries, const OutputOrder order) {
+        QuickSorter<ResultEntry> sorter;
+        switch (order) {
+            case OutputOrder::Table:
+                break;
+            case OutputOrder::CountDescending:
+                sorter.Sort(entries, [](const ResultEntry& left, const ResultEntry& right) {
+                    return left.second != right.second ? left.second > right.second : left.first < right.first;
+                });
+                break;
+            case OutputOrder::KeyAscending:
+                sorter.Sort(entries,
+                            [](const ResultEntry& left, const ResultEntry& right) { return left.first < right.first; });
+                break;
+        }
+    }
+
+    template<typename Table, typename KeyOf>
+    ArraySequence<ResultEntry> collectResults(Table& table, KeyOf&& keyOf) {
+        ArraySequence<ResultEntry> entries(table.GetCount());
+        size_t position = 0;
+        for (const auto& [key, value]: table) {
+            entries[position++] = {keyOf(key), value};
+        }
+        return entries;
+    }
+
+    template<typename Text>
+    void writeTable(const Text& text, ResultWriter& writer, const size_t lmin, const size_t lmax,
+                    const SubsequenceSearchOptions& options) {
+        auto write = [&](ArraySequence<ResultEntry>& entries) {
+            sortResults(entries, options.order);
+            writer.WriteAll(entries, options.threadCount);
+        };
+        auto identity = [](const std::string_view key) { return key; };
+
+        switch (options.engine) {
+            case CountingEngine::HashTable: {
+                if (options.threadCount == 1) {
+                    StringArena arena;
+                    IDictionary<std::string_view, size_t, FNV1a<std::string_view>> prefixTable =
+                            countSubstringsArena(text, lmin, lmax, arena);
+                    ArraySequence<ResultEntry> entries = collectResults(prefixTable, identity);
+                    write(entries);
+                    break;
+                }
+
+                IDictionary<std::string, size_t, FNV1a<std::string>> prefixTable =
+                        countSubstringsParallel(text, lmin, lmax, options.threadCount);
+                ArraySequence<ResultEntry> entries = collectResults(prefixTable, identity);
+                write(entries);
+                break;
+            }
+            case CountingEngine::RollingHash: {
+                IDictionary<SubstringView, size_t, SubstringViewHash> prefixTable =
+                        countSubstringsRolling(text, lmin, lmax);
+                ArraySequence<ResultEntry> entries =
+                        collectResults(prefixTable, [](const SubstringView& key) { return key.text; });
+                write(entries);
+                break;
+            }
+            case CountingEngine::SuffixArray: {
+                const std::string_view content = text.GetText();
+                const SuffixArray suffixArray(content);
+                if (options.order == OutputOrder::Table) {
+                    forEachSubstring(suffixArray, text, lmin, lmax,
+                                     [&](const size_t start, const size_t length, const size_t count) {
+                                         writer.Write(content.substr(start, length), count);
+                                     });
+                    break;
+                }
+
+                ArraySequence<ResultEntry> entries;
+                forEachSubstring(suffixArray, text, lmin, lmax,
+                                 [&](const size_t start, const size_t length, const size_t count) {
+                                     entries.Append({content.substr(start, length), count});
+                                 });
+                write(entries);
+                break;
+            }
+        }
+    }
+
+    void writeNGrams(const std::string_view content, ResultWriter& writer, const size_t lmin, const size_t lmax,
+                     const SubsequenceSearchOptions& options) {
+        const TokenizedText text(content);
+        NGramTable table = createNGramTable(text, lmin, lmax);
+
+        if (options.order == OutputOrder::Table) {
+            std::string joined;
+            for (const auto& [key, value]: table) {
+                joined.clear();
+                key.AppendText(text, joined);
+                writer.Write(joined, value);
+            }
+            return;
+        }
+
+        StringArena arena;
+        std::string joined;
+        ArraySequence<ResultEntry> entries = collectResults(table, [&](const TokenNGram& key) {
+            joined.clear();
+            key.AppendText(text, joined);
+            return arena.Store(joined);
+        });
+        sortResults(entries, options.order);
+        writer.WriteAll(entries, options.threadCount);
+    }
+
+    // Streams the input ("-" is standard input) to feed in streamChunkSize pieces and returns its size in bytes.
+    template<typename Feed>
+    size_t streamInput(const std::string& inputFile, Feed&& feed) {
+        std::ifstream file;
+        if (inputFile != "-") {
+            file.open(inputFile, std::ios::binary);
+            if (!file) {
+                throw std::runtime_error("Failed to open input file.");
+            }
+        }
+        std::istream& input = inputFile == "-" ? std::cin : file;
+
+        size_t total = 0;
+        std::string chunk(streamChunkSize, '\0');
+        while (input) {
+            input.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            const auto count = static_cast<size_t>(input.gcount());
+            feed(std::string_view(chunk.data(), count));
+            total += count;
+        }
+        return total;
+    }
+
+    void processFileExternally(const std::string& inputFile, const std::string& outputDirectory, const size_t lmin,
+                               const size_t lmax, const SubsequenceSearchOptions& options) {
+        if (lmin > lmax) {
+            throw std::out_of_range("Invalid indices");
+        }
+        if (options.order == OutputOrder::CountDescending) {
+            throw std::invalid_argument("Ordering by count needs the whole table in memory.");
+        }
+        if (options.unit != TextUnit::Byte) {
+            throw std::invalid_argument("Counting code points or words needs the whole text in memory.");
+        }
+
+        ExternalSubstringCounter counter(lmin, lmax, options.memoryBudget);
+        if (streamInput(inputFile, [&](const std::string_view chunk) { counter.Feed(chunk); }) == 0) {
+            throw std::out_of_range("Invalid indices");
+        }
+
+        ResultWriter writer(resultPath(outputDirectory, options.format), options.format);
+        counter.Finish([&](const std::string_view key, const size_t count) { writer.Write(key, count); });
+        writer.Close();
     }
 
-    std::string content((std::istreambuf_iterator(inFile)), std::istreambuf_iterator<char>());
-    inFile.close();
+    void processFileApproximately(const std::string& inputFile, const std::string& outputDirectory,
+                                  const size_t lmin, const size_t lmax, const SubsequenceSearchOptions& options) {
+        if (options.topK == 0) {
+            throw std::invalid_argument("Approximate counting reports only the top K substrings of each length.");
+        }
+        if (options.unit != TextUnit::Byte) {
+            throw std::invalid_argument("Approximate counting measures lengths in bytes.");
+        }
 
-    IDictionary<std::string, size_t, FNV1a<std::string>> prefixTable =
-            std::move(createPrefixTable(content, lmin, lmax));
+        ApproximateSubstringCounter counter(lmin, lmax, options.topK, options.approximateError,
+                                            options.approximateFailure);
+        if (streamInput(inputFile, [&](const std::string_view chunk) { counter.Feed(chunk); }) == 0) {
+            throw std::out_of_range("Invalid indices");
+        }
 
-    std::filesystem::path outputPath(outputDirectory);
-    if (!exists(outputPath)) {
-        create_directories(outputPath);
+        ResultWriter writer(resultPath(outputDirectory, options.format), options.format);
+        for (const auto& top: counter.Finish()) {
+            for (const auto& [key, value]: top) {
+                writer.Write(key, value);
+            }
+        }
+        writer.Close();
+
+        std::ofstream report(std::filesystem::path(outputDirectory) / approximationReportName);
+        report << "windows: " << counter.GetTotalWindows() << '\n'
+               << "epsilon: " << counter.GetEpsilon() << '\n'
+               << "delta: " << counter.GetDelta() << '\n'
+               << "sketch: " << counter.GetSketchWidth() << " x " << counter.GetSketchDepth() << ", "
+               << counter.GetSketchBytes() << " bytes\n"
+               << "Every count is at least the true count and, with probability at least " << 1 - counter.GetDelta()
+               << ", at most " << counter.GetErrorBound() << " above it.\n";
+        if (!report) {
+            throw std::runtime_error("Failed to write approximation report.");
+        }
     }
+} // namespace
 
-    std::filesystem::path resultFile = outputPath / "result.txt";
+void processFileAndSaveResults(const std::string& inputFile, const std::string& outputDirectory, size_t lmin,
+                               size_t lmax, const SubsequenceSearchOptions& options) {
+    if (options.approximateError > 0) {
+        processFileApproximately(inputFile, outputDirectory, lmin, lmax, options);
+        return;
+    }
+    if (options.memoryBudget > 0 && options.topK == 0) {
+        processFileExternally(inputFile, outputDirectory, lmin, lmax, options);
+        return;
+    }
+
+    // Only the suffix array jumps around the text; every other engine scans it front to back.
+    const AccessPattern pattern =
+            options.engine == CountingEngine::SuffixArray ? AccessPattern::Random : AccessPattern::Sequential;
+    const MappedFile input(inputFile, pattern);
+    const std::string_view content = input.GetView();
+
+    if (lmin > lmax || content.empty()) {
+        throw std::out_of_range("Invalid indices");
+    }
+
+    ResultWriter writer(resultPath(outputDirectory, options.format), options.format);
 
-    std::ofstream outFile(resultFile);
-    if (!outFile) {
-        throw std::runtime_error("Failed to open output file.");
+    // Top-K results stay grouped by length, most frequent first.
+    if (options.topK > 0) {
+        for (const auto& top:
+             findMostFrequentSubsequences(content, lmin, lmax, options.topK, options.engine, options.unit)) {
+            for (const auto& [key, value]: top) {
+                writer.Write(key, value);
+            }
+        }
+        writer.Close();
+        return;
     }
 
-    for (const auto& [key, value]: prefixTable) {
-        outFile << key << " - " << value << std::endl;
+    if (options.unit == TextUnit::Word) {
+        writeNGrams(content, writer, lmin, lmax, options);
+    } else if (options.unit == TextUnit::CodePoint) {
+        writeTable(CodePointIndex(content), writer, lmin, lmax, options);
+    } else {
+        writeTable(ByteIndex(content), writer, lmin, lmax, options);
     }
 
-    outFile.close();
+    writer.Close();
 }
@@ -0,0 +1,107 @@
+#include "../headers/ResultWriter.h"
+
+#include <charconv>
+#include <stdexcept>
+
+#include "../headers/Parallel.h"
+
+namespace {
+    constexpr char binaryMagic[] = {'S', 'S', 'C', '1'};
+    constexpr size_t entriesPerTask = size_t{1} << 16;
+
+    void appendVarint(std::string& target, size_t value) {
+        while (value >= 0x80) {
+            target.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        target.push_back(static_cast<char>(value));
+    }
+} // namespace
+
+ResultWriter::ResultWriter(const std::filesystem::path& path, const OutputFormat format) :
+    stream(path, format == OutputFormat::Binary ? std::ios::binary | std::ios::out : std::ios::out), format(format) {
+    if (!stream) {
+        throw std::runtime_error("Failed to open output file.");
+    }
+    buffer.reserve(bufferSize + 256);
+    if (format == OutputFormat::Binary) {
+        buffer.append(binaryMagic, sizeof(binaryMagic));
+    }
+}
+
+ResultWriter::~ResultWriter() {
+    if (stream.is_open()) {
+        Flush();
+    }
+}
+
+const char* ResultWriter::FileName(const OutputFormat format) {
+    return format == OutputFormat::Binary ? "result.bin" : "result.txt";
+}
+
+void ResultWriter::Format(std::string& target, const OutputFormat format, const std::string_view key,
+                          const size_t count) {
+    if (format == OutputFormat::Binary) {
+        appendVarint(target, key.size());
+        target.append(key);
+        appendVarint(target, count);
+        return;
+    }
+
+    char digits[20];
+    const auto [end, error] = std::to_chars(digits, digits + sizeof(digits), count);
+    target.append(key);
+    target.append(" - ");
+    target.append(digits, end);
+    target.push_back('\n');
+}
+
+void ResultWriter::Flush() {
+    stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+}
+
+void ResultWriter::Write(const std::string_view key, const size_t count) {
+    Format(buffer, format, key, count);
+    if (buffer.size() >= bufferSize) {
+        Flush();
+    }
+}
+
+void ResultWriter::WriteAll(const ArraySequence<Entry>& entries, const size_t threadCount) {
+    const size_t count = entries.GetLength();
+    const size_t workers = std::min(resolveThreadCount(threadCount), (count + entriesPerTask - 1) / entriesPerTask);
+    if (workers <= 1) {
+        for (const auto& [key, value]: entries) {
+            Write(key, value);
+        }
+        return;
+    }
+
+    // Each round formats workers blocks side by side, then writes them in entry order.
+    ArraySequence<std::string> blocks(workers);
+    for (size_t first = 0; first < count; first += workers * entriesPerTask) {
+        parallelFor(workers, [&](const size_t worker) {
+            std::string& block = blocks[worker];
+            block.clear();
+            const size_t begin = std::min(count, first + worker * entriesPerTask);
+            const size_t end = std::min(count, begin + entriesPerTask);
+            for (size_t index = begin; index < end; ++index) {
+                Format(block, format, entries[index].first, entries[index].second);
+            }
+        });
+
+        Flush();
+        for (const auto& block: blocks) {
+            stream.write(block.data(), static_cast<std::streamsize>(block.size()));
+        }
+    }
+}
+
+void ResultWriter::Close() {
+    Flush();
+    stream.close();
+    if (!stream) {
+        throw std::runtime_error("Failed to write output file.");
+    }
+}
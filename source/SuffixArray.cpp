@@ -0,0 +1,103 @@
+#include "../headers/SuffixArray.h"
+
+#include <algorithm>
+
+SuffixArray::SuffixArray(const std::string_view text) : text(text), suffixes(text.size()), lcp(text.size()) {
+    BuildSuffixes();
+    BuildLcp();
+}
+
+void SuffixArray::BuildSuffixes() {
+    const size_t n = text.size();
+    if (n == 0) {
+        return;
+    }
+
+    ArraySequence<size_t> rank(n);
+    ArraySequence<size_t> buffer(n);
+    ArraySequence<size_t> counts(std::max<size_t>(256, n));
+
+    for (size_t i = 0; i < n; ++i) {
+        ++counts[static_cast<unsigned char>(text[i])];
+    }
+    for (size_t c = 1; c < 256; ++c) {
+        counts[c] += counts[c - 1];
+    }
+    for (size_t i = n; i-- > 0;) {
+        suffixes[--counts[static_cast<unsigned char>(text[i])]] = i;
+    }
+
+    size_t classes = 1;
+    rank[suffixes[0]] = 0;
+    for (size_t i = 1; i < n; ++i) {
+        if (text[suffixes[i]] != text[suffixes[i - 1]]) {
+            ++classes;
+        }
+        rank[suffixes[i]] = classes - 1;
+    }
+
+    for (size_t k = 1; classes < n; k <<= 1) {
+        size_t position = 0;
+        for (size_t i = n - std::min(k, n); i < n; ++i) {
+            buffer[position++] = i;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (suffixes[i] >= k) {
+                buffer[position++] = suffixes[i] - k;
+            }
+        }
+
+        for (size_t c = 0; c < classes; ++c) {
+            counts[c] = 0;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            ++counts[rank[i]];
+        }
+        for (size_t c = 1; c < classes; ++c) {
+            counts[c] += counts[c - 1];
+        }
+        for (size_t i = n; i-- > 0;) {
+            suffixes[--counts[rank[buffer[i]]]] = buffer[i];
+        }
+
+        auto secondKey = [&](const size_t suffix) { return suffix + k < n ? rank[suffix + k] + 1 : 0; };
+
+        buffer[suffixes[0]] = 0;
+        classes = 1;
+        for (size_t i = 1; i < n; ++i) {
+            const size_t current = suffixes[i];
+            const size_t previous = suffixes[i - 1];
+            if (rank[current] != rank[previous] || secondKey(current) != secondKey(previous)) {
+                ++classes;
+            }
+            buffer[current] = classes - 1;
+        }
+        std::swap(rank, buffer);
+    }
+}
+
+void SuffixArray::BuildLcp() {
+    const size_t n = text.size();
+    ArraySequence<size_t> inverse(n);
+    for (size_t i = 0; i < n; ++i) {
+        inverse[suffixes[i]] = i;
+    }
+
+    size_t common = 0;
+    for (size_t position = 0; position < n; ++position) {
+        const size_t index = inverse[position];
+        if (index == 0) {
+            common = 0;
+            continue;
+        }
+
+        const size_t previous = suffixes[index - 1];
+        while (position + common < n && previous + common < n && text[position + common] == text[previous + common]) {
+            ++common;
+        }
+        lcp[index] = common;
+        if (common > 0) {
+            --common;
+        }
+    }
+}
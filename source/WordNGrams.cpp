@@ -0,0 +1,88 @@
+#include "../headers/WordNGrams.h"
+
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    // Length in bytes of the separator starting at position, or 0 if a token byte starts there.
+    size_t separatorLength(const std::string_view text, const size_t position) {
+        const auto byte = static_cast<unsigned char>(text[position]);
+        if (byte < 0x80) {
+            const bool letterOrDigit =
+                    (byte >= '0' && byte <= '9') || (byte >= 'A' && byte <= 'Z') || (byte >= 'a' && byte <= 'z');
+            return letterOrDigit ? 0 : 1;
+        }
+        if (position + 1 >= text.size()) {
+            return 0;
+        }
+
+        const auto next = static_cast<unsigned char>(text[position + 1]);
+        if (byte == 0xC2 && next >= 0xA0 && next <= 0xBF) {
+            return 2;
+        }
+        if (byte == 0xE2 && (next == 0x80 || next == 0x81) && position + 2 < text.size()) {
+            return 3;
+        }
+        return 0;
+    }
+} // namespace
+
+TokenizedText::TokenizedText(const std::string_view text) {
+    IDictionary<std::string_view, TokenId, FNV1a<std::string_view>> interned;
+
+    size_t position = 0;
+    while (position < text.size()) {
+        if (const size_t separator = separatorLength(text, position); separator > 0) {
+            position += separator;
+            continue;
+        }
+
+        const size_t start = position;
+        while (position < text.size() && separatorLength(text, position) == 0) {
+            ++position;
+        }
+
+        const std::string_view token = text.substr(start, position - start);
+        const size_t next = vocabulary.GetLength();
+        const TokenId id = interned.FindOrInsert(token, static_cast<TokenId>(next));
+        if (id == next) {
+            if (next == std::numeric_limits<TokenId>::max()) {
+                throw std::length_error("Too many distinct tokens");
+            }
+            vocabulary.Append(token);
+        }
+        ids.Append(id);
+    }
+}
+
+void TokenNGram::AppendText(const TokenizedText& text, std::string& target) const {
+    for (size_t i = 0; i < length; ++i) {
+        if (i > 0) {
+            target.push_back(' ');
+        }
+        target.append(text.GetToken(tokens[i]));
+    }
+}
+
+NGramTable createNGramTable(const TokenizedText& text, const size_t lmin, const size_t lmax) {
+    const size_t n = text.GetLength();
+    if (lmin == 0 || lmin > lmax || lmax > TokenNGram::maxLength || n == 0) {
+        throw std::out_of_range("Invalid indices");
+    }
+
+    // Grows by incremental rehash, so no single n-gram pays for moving the whole table.
+    NGramTable table(16, 0.9, true);
+
+    for (size_t start = 0; start < n; ++start) {
+        TokenNGram key;
+        for (size_t len = 1; len <= lmax && start + len <= n; ++len) {
+            key.tokens[len - 1] = text.GetId(start + len - 1);
+            key.length = len;
+            if (len >= lmin) {
+                ++table.FindOrInsert(key, 0);
+            }
+        }
+    }
+
+    return table;
+}
@@ -0,0 +1,137 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+#include "../headers/ConcurrentDictionary.h"
+#include "../headers/Parallel.h"
+
+// Threads run Upsert, Add, Get, Contains and Remove against a ConcurrentDictionary with few, small stripes, so
+// the stripes keep resizing while other threads read and write them. Each thread owns the keys congruent to its
+// index and checks them against its own std::unordered_map; all threads also add to a set of shared counters,
+// whose totals are known once every thread has finished.
+namespace {
+    constexpr size_t threadCount = 8;
+    constexpr size_t stripeCount = 4;
+    constexpr uint64_t keysPerThread = 4000;
+    constexpr size_t operationsPerThread = 200000;
+    constexpr uint64_t sharedKeyBase = uint64_t{1} << 40;
+    constexpr uint64_t sharedKeyCount = 64;
+
+    std::atomic<size_t> failures{0};
+    std::mutex reportMutex;
+
+    void check(const bool condition, const std::string& message) {
+        if (!condition && ++failures <= 20) {
+            std::lock_guard lock(reportMutex);
+            std::cerr << message << '\n';
+        }
+    }
+
+    // Mixes every key bit into both halves, so keys spread over the stripes (high bits) and slots (low bits).
+    struct MixedHash {
+        size_t operator()(uint64_t key) const {
+            key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+            return static_cast<size_t>(key ^ (key >> 31));
+        }
+    };
+
+    using Dictionary = ConcurrentDictionary<uint64_t, uint64_t, MixedHash>;
+
+    void runThread(Dictionary& dictionary, const size_t thread, std::unordered_map<uint64_t, uint64_t>& reference,
+                   ArraySequence<uint64_t>& sharedAdds) {
+        std::mt19937_64 generator(thread + 1);
+        const std::string name = "thread " + std::to_string(thread) + ": ";
+
+        for (size_t step = 0; step < operationsPerThread; ++step) {
+            const uint64_t key = generator() % keysPerThread * threadCount + thread;
+            const bool present = reference.contains(key);
+
+            switch (generator() % 8) {
+                case 0:
+                case 1: {
+                    const uint64_t value = dictionary.Upsert(key, [](uint64_t& stored) { stored += 3; }, 1);
+                    reference[key] = present ? reference[key] + 3 : 4;
+                    check(value == reference[key], name + "Upsert returns a wrong value for " + std::to_string(key));
+                    break;
+                }
+                case 2: {
+                    const uint64_t shared = sharedKeyBase + generator() % sharedKeyCount;
+                    dictionary.Add(shared, 1);
+                    ++sharedAdds[shared - sharedKeyBase];
+                    break;
+                }
+                case 3:
+                    try {
+                        const uint64_t value = dictionary.Get(key);
+                        check(present && value == reference[key], name + "Get disagrees for " + std::to_string(key));
+                    } catch (const std::runtime_error&) {
+                        check(!present, name + "Get misses " + std::to_string(key));
+                    }
+                    break;
+                case 4:
+                    check(dictionary.Contains(key) == present, name + "Contains disagrees for " + std::to_string(key));
+                    break;
+                default:
+                    try {
+                        dictionary.Remove(key);
+                        check(present, name + "Remove finds absent " + std::to_string(key));
+                        reference.erase(key);
+                    } catch (const std::runtime_error&) {
+                        check(!present, name + "Remove misses " + std::to_string(key));
+                    }
+                    break;
+            }
+        }
+    }
+} // namespace
+
+int main() {
+    // 16 slots per stripe: every stripe doubles several times while the threads run.
+    Dictionary dictionary(stripeCount, 16);
+    ArraySequence<std::unordered_map<uint64_t, uint64_t>> references(threadCount);
+    ArraySequence<ArraySequence<uint64_t>> sharedAdds(threadCount);
+    for (auto& adds: sharedAdds) {
+        adds = ArraySequence<uint64_t>(sharedKeyCount);
+    }
+
+    parallelFor(threadCount, [&](const size_t thread) {
+        runThread(dictionary, thread, references[thread], sharedAdds[thread]);
+    });
+
+    size_t expectedCount = 0;
+    for (const auto& reference: references) {
+        expectedCount += reference.size();
+        for (const auto& [key, value]: reference) {
+            check(dictionary.Contains(key) && dictionary.Get(key) == value, "key " + std::to_string(key) + " lost");
+        }
+    }
+
+    for (uint64_t shared = 0; shared < sharedKeyCount; ++shared) {
+        uint64_t total = 0;
+        for (const auto& adds: sharedAdds) {
+            total += adds[shared];
+        }
+        if (total == 0) {
+            continue;
+        }
+        ++expectedCount;
+        const uint64_t key = sharedKeyBase + shared;
+        check(dictionary.Contains(key) && dictionary.Get(key) == total,
+              "shared counter " + std::to_string(shared) + " lost updates");
+    }
+
+    check(dictionary.GetCount() == expectedCount, "count differs from the threads' references");
+    check(dictionary.Snapshot().GetCount() == expectedCount, "snapshot misses entries");
+
+    if (failures != 0) {
+        std::cerr << failures << " checks failed\n";
+        return 1;
+    }
+    std::cout << "all checks passed\n";
+    return 0;
+}
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+#include "../headers/IDictionary.h"
+
+// Randomized IDictionary operations checked against std::unordered_map. The build compiles this file twice, once
+// with IDICTIONARY_SIMD and once with IDICTIONARY_SCALAR, so the SSE2 group probe and the scalar probe face the
+// same checks.
+// The hashers below steer keys onto chosen home slots to reach the probe's edge cases.
+namespace {
+    size_t failures = 0;
+
+    void check(const bool condition, const std::string& scenario, const std::string& message) {
+        if (!condition && ++failures <= 20) {
+            std::cerr << scenario << ": " << message << '\n';
+        }
+    }
+
+    size_t mix(uint64_t key) {
+        key += 0x9E3779B97F4A7C15ULL;
+        key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+        return static_cast<size_t>(key ^ (key >> 31));
+    }
+
+    struct MixedHash {
+        size_t operator()(const uint64_t key) const { return mix(key); }
+    };
+
+    // Homes spread over a few slots with differing fingerprints, so runs straddle group boundaries.
+    struct GroupBoundaryHash {
+        size_t operator()(const uint64_t key) const {
+            return (mix(key) & ~size_t{0} << 56) | (key % 11) * 15;
+        }
+    };
+
+    // Every key lands on one of the last slots of any table and shares one fingerprint, so probes wrap past
+    // the end through the mirrored control and fingerprint bytes.
+    struct TailHash {
+        size_t operator()(const uint64_t key) const { return ~size_t{0} - key % 7; }
+    };
+
+    // Three home slots and one fingerprint for all keys: probe distances pass 255 and saturate the control byte.
+    struct ClusterHash {
+        size_t operator()(const uint64_t key) const { return key % 3; }
+    };
+
+    template<typename Hasher>
+    void verifyContents(IDictionary<uint64_t, uint64_t, Hasher>& dictionary,
+                        const std::unordered_map<uint64_t, uint64_t>& reference, const std::string& scenario) {
+        check(dictionary.GetCount() == reference.size(), scenario, "count differs from reference");
+        size_t visited = 0;
+        for (const auto& [key, value]: dictionary) {
+            const auto expected = reference.find(key);
+            check(expected != reference.end() && expected->second == value, scenario,
+                  "iteration yields key " + std::to_string(key) + " with a wrong value");
+            ++visited;
+        }
+        check(visited == reference.size(), scenario, "iteration visits a wrong number of entries");
+        for (const auto& [key, value]: reference) {
+            check(dictionary.Contains(key) && dictionary.Get(key) == value, scenario,
+                  "key " + std::to_string(key) + " lost");
+        }
+    }
+
+    template<typename Hasher>
+    void runScenario(const std::string& name, const uint64_t universe, const size_t operations,
+                     const size_t requiredPeak, const float loadFactor, const bool incremental) {
+        const std::string scenario = name + (incremental ? "/incremental" : "/one-shot") + "/load " +
+                                     std::to_string(loadFactor);
+        IDictionary<uint64_t, uint64_t, Hasher> dictionary(16, loadFactor, incremental);
+        std::unordered_map<uint64_t, uint64_t> reference;
+        std::mt19937_64 generator(universe * 31 + operations);
+        size_t peak = 0;
+
+        for (size_t step = 0; step < operations; ++step) {
+            const uint64_t key = generator() % universe;
+            const bool present = reference.contains(key);
+            // Grow for the first half, then lean towards removals so backward shifts run through long clusters.
+            const unsigned operation = generator() % (step < operations / 2 ? 8 : 10);
+
+            switch (operation) {
+                case 0:
+                    dictionary.Insert(key, step);
+                    reference[key] = step;
+                    break;
+                case 1:
+                    ++dictionary.FindOrInsert(key, 0);
+                    ++reference[key];
+                    break;
+                case 2:
+                    dictionary.Upsert(key, [](uint64_t& value) { value += 2; });
+                    reference[key] += 2;
+                    break;
+                case 3:
+                    try {
+                        dictionary[key] = step * 3;
+                        check(present, scenario, "operator[] finds absent key " + std::to_string(key));
+                        reference[key] = step * 3;
+                    } catch (const std::runtime_error&) {
+                        check(!present, scenario, "operator[] misses key " + std::to_string(key));
+                    }
+                    break;
+                case 4: {
+                    const uint64_t* value = dictionary.Find(key);
+                    check((value != nullptr) == present && (!present || *value == reference[key]), scenario,
+                          "Find disagrees for key " + std::to_string(key));
+                    break;
+                }
+                case 5:
+                    check(dictionary.Contains(key) == present, scenario,
+                          "Contains disagrees for key " + std::to_string(key));
+                    break;
+                case 6:
+                    try {
+                        const uint64_t value = dictionary.Get(key);
+                        check(present && value == reference[key], scenario,
+                              "Get returns a value for key " + std::to_string(key) + " that does not match");
+                    } catch (const std::runtime_error&) {
+                        check(!present, scenario, "Get misses key " + std::to_string(key));
+                    }
+                    break;
+                default:
+                    try {
+                        dictionary.Remove(key);
+                        check(present, scenario, "Remove finds absent key " + std::to_string(key));
+                        reference.erase(key);
+                    } catch (const std::runtime_error&) {
+                        check(!present, scenario, "Remove misses key " + std::to_string(key));
+                    }
+                    break;
+            }
+
+            peak = std::max(peak, reference.size());
+            if (step % 1024 == 0) {
+                verifyContents(dictionary, reference, scenario);
+            }
+        }
+        verifyContents(dictionary, reference, scenario);
+        check(peak >= requiredPeak, scenario, "never held enough keys to reach its edge case");
+
+        // Same contents in another layout must still compare equal.
+        IDictionary<uint64_t, uint64_t, Hasher> rebuilt(reference.size() * 2, 0.5F, !incremental);
+        for (const auto& [key, value]: reference) {
+            rebuilt.Insert(key, value);
+        }
+        check(dictionary == rebuilt, scenario, "operator== compares layout instead of contents");
+
+        for (const auto& [key, value]: std::unordered_map(reference)) {
+            try {
+                dictionary.Remove(key);
+            } catch (const std::runtime_error&) {
+                check(false, scenario, "Remove misses key " + std::to_string(key));
+            }
+            reference.erase(key);
+        }
+        verifyContents(dictionary, reference, scenario);
+    }
+
+    template<typename Hasher>
+    void runAllModes(const std::string& name, const uint64_t universe, const size_t operations,
+                     const size_t requiredPeak = 0) {
+        for (const bool incremental: {false, true}) {
+            for (const float loadFactor: {0.5F, 0.9F}) {
+                runScenario<Hasher>(name, universe, operations, requiredPeak, loadFactor, incremental);
+            }
+        }
+    }
+} // namespace
+
+int main() {
+#ifdef IDICTIONARY_SSE2
+    std::cout << "probe: SSE2 groups\n";
+#else
+    std::cout << "probe: scalar\n";
+#endif
+
+    runAllModes<MixedHash>("mixed", 20000, 100000);
+    runAllModes<GroupBoundaryHash>("group boundaries", 400, 40000);
+    // More than 7 keys must wrap; more than 3 * 256 keys put some key at least 256 slots from home.
+    runAllModes<TailHash>("wraparound", 300, 30000, 8);
+    runAllModes<ClusterHash>("saturated distances", 1200, 40000, 3 * 256 + 1);
+
+    if (failures != 0) {
+        std::cerr << failures << " checks failed\n";
+        return 1;
+    }
+    std::cout << "all checks passed\n";
+    return 0;
+}